@@ -37,8 +37,11 @@ void testGraphFromFile(const char* filename) {
     GraphCheckInvariants(graph);
 
     printf("Running Bellman-Ford Algorithm:\n");
+    // Print the time, memory and operation counts of each run
+    GraphBellmanFordAlgOptions options = GraphBellmanFordAlgDefaultOptions();
+    options.verbose = 1;
     for (unsigned int i = 0; i < GraphGetNumVertices(graph); i++) {
-        GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(graph, i);
+        GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecuteWithOptions(graph, i, &options);
         if (BF_result) {
             printf("The shortest path tree rooted at %u:\n", i);
             GraphBellmanFordAlgDisplayDOT(BF_result);
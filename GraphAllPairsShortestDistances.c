@@ -16,108 +16,1210 @@
 #include "GraphAllPairsShortestDistances.h"
 
 #include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "Graph.h"
 #include "GraphBellmanFordAlg.h"
+#include "GraphCSR.h"
+#include "GraphDistanceMatrix.h"
+#include "GraphDistanceRowCache.h"
+#include "GraphFloydWarshall.h"
+#include "GraphJohnson.h"
+#include "GraphMultiSourceBFS.h"
+#include "GraphStronglyConnectedComponents.h"
+
+typedef struct _MatrizBlocos MatrizBlocos;
 
 struct _GraphAllPairsShortestDistances {
-  int** distance;  // The 2D matrix storing the all-pairs shortest distances
-                   // It is stored as an array of pointers to 1D rows
-                   // Idea: an INDEFINITE distance value is stored as -1
+  GraphDistanceMatrix* distance;  // The 2D matrix storing the all-pairs
+                                  // shortest distances, in a single block
+                                  // An INDEFINITE distance is read as -1
+                                  // (INFINITY, in a weighted graph)
+                                  // NULL, if the rows are computed on demand
+                                  // or stored by blocks
+  MatrizBlocos* blocos;           // The reachable pairs only, or NULL
   Graph* graph;
+  // On demand: the rows in use, and what computes them
+  GraphDistanceRowCache* cache;
+  size_t maxCacheBytes;
+  GraphCSR* adjacencias;
+  GraphBellmanFordAlgWorkspace* espaco;  // Sem pesos
+  GraphJohnson* johnson;                 // Com pesos
+  GraphJohnsonSearch* dijkstra;
 };
 
 // Allocate memory and initialize the distance matrix
 // Compute the distances between vertices by running the Bellman-Ford algorithm
 // Função para calcular todas as distâncias mais curtas entre pares de vértices
 
-// Função auxiliar para inicializar a matriz de distâncias
-static int** InicializarMatrizDistancias(unsigned int numVertices) {
-    int** matriz = (int**)malloc(numVertices * sizeof(int*));
-    if (matriz == NULL) return NULL;
+// Função auxiliar para limitar o diâmetro, i.e., a maior distância finita
+// Num caminho mais curto não há vértices repetidos: no máximo V-1 arestas.
+// Num grafo não orientado, dois vértices quaisquer de uma componente estão
+// a uma distância de, no máximo, o dobro da excentricidade de qualquer
+// vértice da componente: uma BFS por componente, O(V + E), dá um limite
+// muito menor, e a matriz pode usar entradas mais estreitas
+static unsigned int LimiteDiametro(const GraphCSR* adjacencias) {
+    unsigned int numVertices = GraphCSRGetNumVertices(adjacencias);
+    unsigned int limite = numVertices > 0 ? numVertices - 1 : 0;
+    if (GraphCSRIsDigraph(adjacencias)) return limite;
+
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(adjacencias);
+    const unsigned int* vizinhos = GraphCSRGetTargets(adjacencias);
+    // Fila da BFS e nível de cada vértice (-1: ainda não visitado)
+    unsigned int* fila = (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+    int* nivel = (int*)malloc((numVertices + 1) * sizeof(int));
+    if (fila == NULL || nivel == NULL) abort();
+    for (unsigned int v = 0; v < numVertices; v++) nivel[v] = -1;
 
-    for (unsigned int i = 0; i < numVertices; i++) {
-        matriz[i] = (int*)malloc(numVertices * sizeof(int));
-        if (matriz[i] == NULL) {
-            for (unsigned int j = 0; j < i; j++) {
-                free(matriz[j]);
+    unsigned int maiorNivel = 0;
+    for (unsigned int raiz = 0; raiz < numVertices; raiz++) {
+        if (nivel[raiz] != -1) continue;
+        unsigned int cabeca = 0, cauda = 0;
+        fila[cauda++] = raiz;
+        nivel[raiz] = 0;
+        while (cabeca < cauda) {
+            unsigned int v = fila[cabeca++];
+            for (unsigned int k = inicioVizinhos[v]; k < inicioVizinhos[v + 1]; k++) {
+                unsigned int w = vizinhos[k];
+                if (nivel[w] == -1) {
+                    nivel[w] = nivel[v] + 1;
+                    fila[cauda++] = w;
+                }
             }
-            free(matriz);
-            return NULL;
+        }
+        // O último vértice retirado da fila é o mais afastado da raiz
+        if ((unsigned int)nivel[fila[cauda - 1]] > maiorNivel) {
+            maiorNivel = (unsigned int)nivel[fila[cauda - 1]];
         }
     }
-    return matriz;
+    free(fila);
+    free(nivel);
+
+    return 2 * maiorNivel < limite ? 2 * maiorNivel : limite;
+}
+
+// Numa matriz simétrica, cada origem guarda apenas as distâncias aos
+// vértices seguintes: as restantes foram, ou serão, guardadas pelas
+// origens anteriores, como distâncias a esta origem, e nenhuma entrada é
+// escrita por duas threads
+static unsigned int PrimeiroDestino(const GraphDistanceMatrix* matriz, unsigned int linha) {
+    return GraphDistanceMatrixIsSymmetric(matriz) ? linha : 0;
 }
 
-// Função auxiliar para liberar a matriz de distâncias
-static void LiberarMatrizDistancias(int** matriz, unsigned int numVertices) {
-    for (unsigned int i = 0; i < numVertices; i++) {
-        free(matriz[i]);
+// Função auxiliar para processar as distâncias a partir de um vértice,
+// guardadas na linha indicada da matriz
+// O espaço de trabalho é partilhado por todas as origens: nenhuma execução
+// aloca memória, e os predecessores não são registados
+// Devolve 0 se for alcançado um ciclo negativo
+static int ProcessarDistanciasVertice(GraphBellmanFordAlgWorkspace* espaco, GraphDistanceMatrix* matriz, unsigned int linha, unsigned int vertice, unsigned int numVertices) {
+    GraphBellmanFordAlgOptions opcoes = GraphBellmanFordAlgDefaultOptions();
+    opcoes.trackPredecessors = 0;
+
+    const GraphBellmanFordAlg* algoritmoBF = GraphBellmanFordAlgExecuteInWorkspace(espaco, vertice, &opcoes);
+    if (algoritmoBF == NULL) return 0;
+
+    for (unsigned int destino = PrimeiroDestino(matriz, linha); destino < numVertices; destino++) {
+        if (GraphDistanceMatrixIsWeighted(matriz)) {
+            // INFINITY para os vértices inacessíveis
+            GraphDistanceMatrixSetWeighted(matriz, linha, destino, GraphBellmanFordAlgWeightedDistance(algoritmoBF, destino));
+        } else {
+            // GraphBellmanFordAlgDistance devolve -1 para os vértices inacessíveis
+            GraphDistanceMatrixSet(matriz, linha, destino, GraphBellmanFordAlgDistance(algoritmoBF, destino));
+        }
     }
-    free(matriz);
+    return 1;
 }
 
-// Função auxiliar para processar as distâncias a partir de um vértice
-static void ProcessarDistanciasVertice(Graph* grafo, int** matriz, unsigned int vertice, unsigned int numVertices) {
-    GraphBellmanFordAlg* algoritmoBF = GraphBellmanFordAlgExecute(grafo, vertice);
-    assert(algoritmoBF != NULL); // Certifica que o algoritmo foi executado corretamente
+// Função auxiliar para copiar uma linha de distâncias reais para a matriz
+static void GuardarLinha(GraphDistanceMatrix* matriz, unsigned int linha, const double* distancias, unsigned int numVertices) {
+    for (unsigned int destino = PrimeiroDestino(matriz, linha); destino < numVertices; destino++) {
+        if (GraphDistanceMatrixIsWeighted(matriz)) {
+            GraphDistanceMatrixSetWeighted(matriz, linha, destino, distancias[destino]);
+        } else if (distancias[destino] != INFINITY) {
+            GraphDistanceMatrixSet(matriz, linha, destino, (int)distancias[destino]);
+        }
+    }
+}
+
+// Matriz por blocos
+// Os vértices de uma componente fortemente conexa alcançam exatamente os
+// mesmos vértices: os das componentes alcançáveis a partir da sua, no
+// grafo condensado. Cada componente c tem um bloco denso, com uma linha
+// por vértice de c e uma coluna por vértice alcançável, agrupadas por
+// componente: os pares sem caminho não ocupam memória, nem são escritos.
+struct _MatrizBlocos {
+    GraphSCC* componentes;
+    // As componentes alcançáveis a partir de c, por ordem crescente, são
+    // alcance[inicioAlcance[c]] ... alcance[inicioAlcance[c+1]-1]; as
+    // colunas dos vértices de alcance[k] começam em colunaAlcance[k]
+    size_t* inicioAlcance;
+    unsigned int* alcance;
+    unsigned int* colunaAlcance;
+    GraphDistanceMatrix** blocos;  // Por componente
+    size_t numBytes;
+};
+
+static int CompararComponentes(const void* a, const void* b) {
+    unsigned int x = *(const unsigned int*)a;
+    unsigned int y = *(const unsigned int*)b;
+    return (x > y) - (x < y);
+}
+
+// Acrescenta a componente d ao fim do alcance, com total componentes
+static void AcrescentarAlcance(MatrizBlocos* blocos, size_t* capacidade, size_t total, unsigned int d) {
+    if (total == *capacidade) {
+        *capacidade *= 2;
+        blocos->alcance = (unsigned int*)realloc(blocos->alcance, *capacidade * sizeof(unsigned int));
+        blocos->colunaAlcance = (unsigned int*)realloc(blocos->colunaAlcance, *capacidade * sizeof(unsigned int));
+        if (blocos->alcance == NULL || blocos->colunaAlcance == NULL) abort();
+    }
+    blocos->alcance[total] = d;
+}
+
+static void DestruirMatrizBlocos(MatrizBlocos** p) {
+    MatrizBlocos* blocos = *p;
+    unsigned int numComponentes = GraphSCCGetNumComponents(blocos->componentes);
+    if (blocos->blocos != NULL) {
+        for (unsigned int c = 0; c < numComponentes; c++) {
+            if (blocos->blocos[c] != NULL) GraphDistanceMatrixDestroy(&blocos->blocos[c]);
+        }
+        free(blocos->blocos);
+    }
+    free(blocos->inicioAlcance);
+    free(blocos->alcance);
+    free(blocos->colunaAlcance);
+    GraphSCCDestroy(&blocos->componentes);
+    free(blocos);
+    *p = NULL;
+}
+
+// Cria a matriz por blocos, com todas as entradas inacessíveis
+// Devolve NULL se os blocos ocupariam mais do que maxBytes: há poucos
+// pares sem caminho
+static MatrizBlocos* CriarMatrizBlocos(const GraphCSR* adjacencias, int comPesos, unsigned int limite, size_t maxBytes) {
+    GraphSCC* componentes = GraphSCCCompute(adjacencias);
+    unsigned int numComponentes = GraphSCCGetNumComponents(componentes);
+    // Uma só componente: a matriz completa
+    if (numComponentes <= 1) {
+        GraphSCCDestroy(&componentes);
+        return NULL;
+    }
+
+    MatrizBlocos* blocos = (MatrizBlocos*)malloc(sizeof(MatrizBlocos));
+    if (blocos == NULL) abort();
+    blocos->componentes = componentes;
+    blocos->blocos = NULL;
+    blocos->inicioAlcance = (size_t*)malloc((numComponentes + 1) * sizeof(size_t));
+    size_t capacidade = 2 * (size_t)numComponentes;
+    blocos->alcance = (unsigned int*)malloc(capacidade * sizeof(unsigned int));
+    blocos->colunaAlcance = (unsigned int*)malloc(capacidade * sizeof(unsigned int));
+    // visto[d] == c + 1: d já foi alcançada a partir de c
+    unsigned int* visto = (unsigned int*)calloc(numComponentes, sizeof(unsigned int));
+    if (blocos->inicioAlcance == NULL || blocos->alcance == NULL || blocos->colunaAlcance == NULL || visto == NULL) abort();
+
+    const unsigned int* inicioComponente = GraphSCCGetComponentOffsets(componentes);
+    const unsigned int* inicioArcos = GraphSCCGetCondensationOffsets(componentes);
+    const unsigned int* arcos = GraphSCCGetCondensationTargets(componentes);
+    size_t bytesEntrada = comPesos ? sizeof(double) : GraphDistanceMatrixEntryBytesFor(limite);
+
+    // Alcance de cada componente: uma pesquisa no grafo condensado, cuja
+    // fila é o próprio alcance
+    size_t total = 0;
+    size_t numBytes = 0;
+    for (unsigned int c = 0; c < numComponentes && numBytes <= maxBytes; c++) {
+        blocos->inicioAlcance[c] = total;
+        AcrescentarAlcance(blocos, &capacidade, total++, c);
+        visto[c] = c + 1;
+        for (size_t cabeca = blocos->inicioAlcance[c]; cabeca < total; cabeca++) {
+            unsigned int d = blocos->alcance[cabeca];
+            for (unsigned int k = inicioArcos[d]; k < inicioArcos[d + 1]; k++) {
+                if (visto[arcos[k]] == c + 1) continue;
+                visto[arcos[k]] = c + 1;
+                AcrescentarAlcance(blocos, &capacidade, total++, arcos[k]);
+            }
+        }
+        qsort(blocos->alcance + blocos->inicioAlcance[c], total - blocos->inicioAlcance[c], sizeof(unsigned int), CompararComponentes);
+
+        unsigned int coluna = 0;
+        for (size_t k = blocos->inicioAlcance[c]; k < total; k++) {
+            blocos->colunaAlcance[k] = coluna;
+            unsigned int d = blocos->alcance[k];
+            coluna += inicioComponente[d + 1] - inicioComponente[d];
+        }
+        size_t linhas = inicioComponente[c + 1] - inicioComponente[c];
+        numBytes += linhas * coluna * bytesEntrada + 2 * sizeof(unsigned int) * (total - blocos->inicioAlcance[c]);
+    }
+    blocos->inicioAlcance[numComponentes] = total;
+    free(visto);
+
+    if (numBytes > maxBytes) {
+        DestruirMatrizBlocos(&blocos);
+        return NULL;
+    }
+
+    blocos->blocos = (GraphDistanceMatrix**)malloc(numComponentes * sizeof(GraphDistanceMatrix*));
+    if (blocos->blocos == NULL) abort();
+    blocos->numBytes = 0;
+    for (unsigned int c = 0; c < numComponentes; c++) {
+        size_t ultima = blocos->inicioAlcance[c + 1] - 1;
+        unsigned int d = blocos->alcance[ultima];
+        unsigned int numColunas = blocos->colunaAlcance[ultima] + inicioComponente[d + 1] - inicioComponente[d];
+        unsigned int numLinhas = inicioComponente[c + 1] - inicioComponente[c];
+        blocos->blocos[c] = comPesos ? GraphDistanceMatrixCreateWeightedRows(numLinhas, numColunas)
+                                     : GraphDistanceMatrixCreateRows(numLinhas, numColunas, limite);
+        blocos->numBytes += GraphDistanceMatrixGetMemoryBytes(blocos->blocos[c]);
+    }
+    blocos->numBytes += total * 2 * sizeof(unsigned int);
+
+    return blocos;
+}
 
-    for (unsigned int destino = 0; destino < numVertices; destino++) {
-        if (GraphBellmanFordAlgReached(algoritmoBF, destino)) {
-            matriz[vertice][destino] = GraphBellmanFordAlgDistance(algoritmoBF, destino);
+// A coluna de w no bloco da componente c, ou UINT_MAX se w não é
+// alcançável a partir de c: pesquisa binária no alcance de c
+static unsigned int ColunaBloco(const MatrizBlocos* blocos, unsigned int c, unsigned int w) {
+    unsigned int d = GraphSCCGetComponent(blocos->componentes, w);
+    size_t inicio = blocos->inicioAlcance[c];
+    size_t fim = blocos->inicioAlcance[c + 1];
+    while (inicio < fim) {
+        size_t meio = inicio + (fim - inicio) / 2;
+        if (blocos->alcance[meio] < d) {
+            inicio = meio + 1;
         } else {
-            matriz[vertice][destino] = -1; // Marca como inacessível
+            fim = meio;
         }
     }
+    if (inicio == blocos->inicioAlcance[c + 1] || blocos->alcance[inicio] != d) return UINT_MAX;
+    return blocos->colunaAlcance[inicio] + GraphSCCGetIndexInComponent(blocos->componentes, w);
+}
+
+// Os vértices alcançáveis a partir da componente c, por ordem das colunas
+// do seu bloco, são vertices[inicioComponente[d]] ... para cada d alcançável
+#define PARA_CADA_COLUNA(blocos, c, coluna, destino, corpo)                                         \
+    do {                                                                                           \
+        const unsigned int* inicioComponente_ = GraphSCCGetComponentOffsets((blocos)->componentes); \
+        const unsigned int* vertices_ = GraphSCCGetVertices((blocos)->componentes);                 \
+        unsigned int coluna = 0;                                                                   \
+        for (size_t k_ = (blocos)->inicioAlcance[c]; k_ < (blocos)->inicioAlcance[(c) + 1]; k_++) { \
+            unsigned int d_ = (blocos)->alcance[k_];                                               \
+            for (unsigned int i_ = inicioComponente_[d_]; i_ < inicioComponente_[d_ + 1]; i_++) {  \
+                unsigned int destino = vertices_[i_];                                              \
+                corpo;                                                                             \
+                coluna++;                                                                          \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+// Bellman-Ford a partir de um vértice, guardando apenas as distâncias aos
+// vértices alcançáveis
+static int ProcessarDistanciasVerticeBlocos(GraphBellmanFordAlgWorkspace* espaco, MatrizBlocos* blocos, unsigned int vertice) {
+    GraphBellmanFordAlgOptions opcoes = GraphBellmanFordAlgDefaultOptions();
+    opcoes.trackPredecessors = 0;
 
-    GraphBellmanFordAlgDestroy(&algoritmoBF);
+    const GraphBellmanFordAlg* algoritmoBF = GraphBellmanFordAlgExecuteInWorkspace(espaco, vertice, &opcoes);
+    if (algoritmoBF == NULL) return 0;
+
+    unsigned int c = GraphSCCGetComponent(blocos->componentes, vertice);
+    unsigned int linha = GraphSCCGetIndexInComponent(blocos->componentes, vertice);
+    GraphDistanceMatrix* bloco = blocos->blocos[c];
+    if (GraphDistanceMatrixIsWeighted(bloco)) {
+        PARA_CADA_COLUNA(blocos, c, coluna, destino,
+            GraphDistanceMatrixSetWeighted(bloco, linha, coluna, GraphBellmanFordAlgWeightedDistance(algoritmoBF, destino)));
+    } else {
+        PARA_CADA_COLUNA(blocos, c, coluna, destino,
+            GraphDistanceMatrixSet(bloco, linha, coluna, GraphBellmanFordAlgDistance(algoritmoBF, destino)));
+    }
+    return 1;
+}
+
+// Copia as distâncias reais aos vértices alcançáveis para o bloco
+static void GuardarLinhaBlocos(MatrizBlocos* blocos, unsigned int origem, const double* distancias) {
+    unsigned int c = GraphSCCGetComponent(blocos->componentes, origem);
+    unsigned int linha = GraphSCCGetIndexInComponent(blocos->componentes, origem);
+    GraphDistanceMatrix* bloco = blocos->blocos[c];
+    if (GraphDistanceMatrixIsWeighted(bloco)) {
+        PARA_CADA_COLUNA(blocos, c, coluna, destino,
+            GraphDistanceMatrixSetWeighted(bloco, linha, coluna, distancias[destino]));
+    } else {
+        PARA_CADA_COLUNA(blocos, c, coluna, destino,
+            if (distancias[destino] != INFINITY) GraphDistanceMatrixSet(bloco, linha, coluna, (int)distancias[destino]));
+    }
+}
+
+// A distância de v a w, INFINITY se w não é alcançável
+static double DistanciaBlocos(const MatrizBlocos* blocos, unsigned int v, unsigned int w) {
+    unsigned int c = GraphSCCGetComponent(blocos->componentes, v);
+    unsigned int coluna = ColunaBloco(blocos, c, w);
+    if (coluna == UINT_MAX) return INFINITY;
+    return GraphDistanceMatrixGetWeighted(blocos->blocos[c], GraphSCCGetIndexInComponent(blocos->componentes, v), coluna);
+}
+
+// Contexto da BFS multi-fonte: a matriz (ou os blocos) e as origens do
+// lote atual
+typedef struct {
+    GraphDistanceMatrix* matriz;
+    MatrizBlocos* blocos;
+    const unsigned int* origens;
+} ContextoLoteBFS;
+
+// Regista a distância de cada origem do lote que chega agora ao vértice
+static void RegistarDistanciasLote(void* contexto, unsigned int vertice, unsigned int nivel, const uint64_t* novasOrigens) {
+    ContextoLoteBFS* lote = (ContextoLoteBFS*)contexto;
+    for (unsigned int palavra = 0; palavra < GRAPH_MSBFS_WORDS; palavra++) {
+        uint64_t bits = novasOrigens[palavra];
+        while (bits != 0) {
+            unsigned int i = 64 * palavra + (unsigned int)__builtin_ctzll(bits);
+            unsigned int origem = lote->origens[i];
+            if (lote->blocos != NULL) {
+                // A BFS só chega a vértices alcançáveis
+                unsigned int c = GraphSCCGetComponent(lote->blocos->componentes, origem);
+                GraphDistanceMatrixSet(lote->blocos->blocos[c], GraphSCCGetIndexInComponent(lote->blocos->componentes, origem),
+                                       ColunaBloco(lote->blocos, c, vertice), (int)nivel);
+            } else if (vertice >= PrimeiroDestino(lote->matriz, origem)) {
+                GraphDistanceMatrixSet(lote->matriz, origem, vertice, (int)nivel);
+            }
+            bits &= bits - 1; // Remove o bit menos significativo
+        }
+    }
+}
+
+// Processa as distâncias das origens nas posições primeira ..
+// primeira+numOrigens-1 da ordem (NULL: as próprias posições), com
+// numOrigens <= GRAPH_MSBFS_MAX_SOURCES
+// Todas as entradas da matriz começam como inacessíveis
+static void ProcessarLoteMultiFonte(GraphMSBFS* bfs, GraphDistanceMatrix* matriz, MatrizBlocos* blocos, const unsigned int* ordem, unsigned int primeira, unsigned int numOrigens) {
+    unsigned int origens[GRAPH_MSBFS_MAX_SOURCES];
+    ContextoLoteBFS lote = {matriz, blocos, origens};
+
+    for (unsigned int i = 0; i < numOrigens; i++) {
+        origens[i] = ordem != NULL ? ordem[primeira + i] : primeira + i;
+    }
+
+    GraphMSBFSRun(bfs, origens, numOrigens, RegistarDistanciasLote, &lote);
+}
+
+// Execução em paralelo
+// Cada origem escreve apenas a sua linha da matriz: as origens são
+// repartidas em blocos, atribuídos dinamicamente às threads através de um
+// contador atómico, e a matriz é igual à da execução sequencial.
+// Cada thread tem o seu espaço de trabalho (Bellman-Ford), o seu motor
+// (BFS multi-fonte) ou a sua pesquisa (Dijkstra, de Johnson); o CSR e os
+// potenciais de Johnson são partilhados, apenas para leitura.
+
+// Origens por bloco: um lote completo da BFS multi-fonte, ou um número de
+// execuções de Bellman-Ford ou de Dijkstra que dilui o custo do contador
+// atómico
+#define ORIGENS_POR_BLOCO_BF 16
+
+typedef struct {
+    Graph* grafo;
+    const GraphCSR* adjacencias;  // Partilhada por todos os trabalhadores
+    int bellmanFord;              // 1: cada trabalhador cria o seu espaço
+    GraphDistanceMatrix* matriz;
+    MatrizBlocos* blocos;       // Em vez da matriz: as origens são tomadas
+                                // componente a componente
+    unsigned int numVertices;
+    unsigned int fimOrigens;    // As origens são as linhas da matriz
+    unsigned int origensPorBloco;
+    atomic_uint proximaOrigem;  // Primeira origem do próximo bloco
+    atomic_int cicloNegativo;   // 1: as restantes origens são ignoradas
+} TrabalhoPartilhado;
+
+typedef struct {
+    TrabalhoPartilhado* partilhado;
+    // Apenas um não é NULL, conforme o algoritmo
+    GraphBellmanFordAlgWorkspace* espaco;
+    GraphMSBFS* bfs;
+    GraphJohnsonSearch* dijkstra;
+} Trabalhador;
+
+static void* ExecutarTrabalhador(void* argumento) {
+    Trabalhador* trabalhador = (Trabalhador*)argumento;
+    TrabalhoPartilhado* partilhado = trabalhador->partilhado;
+
+    // O espaço de Bellman-Ford só lê a CSR partilhada: é criado aqui, em
+    // paralelo com os dos outros trabalhadores
+    if (partilhado->bellmanFord) {
+        trabalhador->espaco = GraphBellmanFordAlgWorkspaceCreateShared(partilhado->grafo, partilhado->adjacencias);
+    }
+
+    while (!atomic_load(&partilhado->cicloNegativo)) {
+        unsigned int primeira = atomic_fetch_add(&partilhado->proximaOrigem, partilhado->origensPorBloco);
+        if (primeira >= partilhado->fimOrigens) break;
+        unsigned int numOrigens = partilhado->fimOrigens - primeira;
+        if (numOrigens > partilhado->origensPorBloco) numOrigens = partilhado->origensPorBloco;
+
+        // Por blocos, as origens de cada lote são, quase sempre, da mesma
+        // componente
+        MatrizBlocos* blocos = partilhado->blocos;
+        const unsigned int* ordem = blocos != NULL ? GraphSCCGetVertices(blocos->componentes) : NULL;
+        if (trabalhador->bfs != NULL) {
+            ProcessarLoteMultiFonte(trabalhador->bfs, partilhado->matriz, blocos, ordem, primeira, numOrigens);
+        } else if (trabalhador->dijkstra != NULL) {
+            for (unsigned int posicao = primeira; posicao < primeira + numOrigens; posicao++) {
+                unsigned int origem = ordem != NULL ? ordem[posicao] : posicao;
+                const double* distancias = GraphJohnsonSearchRun(trabalhador->dijkstra, origem);
+                if (blocos != NULL) {
+                    GuardarLinhaBlocos(blocos, origem, distancias);
+                } else {
+                    GuardarLinha(partilhado->matriz, origem, distancias, partilhado->numVertices);
+                }
+            }
+        } else {
+            for (unsigned int posicao = primeira; posicao < primeira + numOrigens; posicao++) {
+                unsigned int origem = ordem != NULL ? ordem[posicao] : posicao;
+                int semCiclos = blocos != NULL
+                    ? ProcessarDistanciasVerticeBlocos(trabalhador->espaco, blocos, origem)
+                    : ProcessarDistanciasVertice(trabalhador->espaco, partilhado->matriz, origem, origem, partilhado->numVertices);
+                if (!semCiclos) {
+                    atomic_store(&partilhado->cicloNegativo, 1);
+                    break;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// Número de threads efetivo: 0 pede uma por processador, e não há mais
+// threads do que blocos
+static unsigned int NumeroThreads(unsigned int pedidas, unsigned int numBlocos) {
+    if (pedidas == 0) {
+        long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+        pedidas = processadores > 0 ? (unsigned int)processadores : 1;
+    }
+    if (pedidas > numBlocos) pedidas = numBlocos;
+    return pedidas > 0 ? pedidas : 1;
+}
+
+// Processa as origens que correspondem às linhas da matriz, ou todas as
+// origens, se a matriz é guardada por blocos (matriz NULL)
+// Johnson: os potenciais (johnson) já foram calculados
+// Devolve 0 se houver um ciclo negativo
+static int ProcessarDistanciasParalelo(Graph* grafo, const GraphCSR* adjacencias, const GraphJohnson* johnson, GraphDistanceMatrix* matriz, MatrizBlocos* blocos, GraphAllPairsShortestDistancesEngine motor, unsigned int threadsPedidas) {
+    int multiFonte = motor == GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS;
+    assert((motor == GRAPH_APSD_ENGINE_JOHNSON) == (johnson != NULL));
+    assert((matriz == NULL) != (blocos == NULL));
+
+    unsigned int primeira = matriz != NULL ? GraphDistanceMatrixGetFirstRow(matriz) : 0;
+    TrabalhoPartilhado partilhado;
+    partilhado.grafo = grafo;
+    partilhado.adjacencias = adjacencias;
+    partilhado.bellmanFord = motor == GRAPH_APSD_ENGINE_BELLMAN_FORD;
+    partilhado.matriz = matriz;
+    partilhado.blocos = blocos;
+    partilhado.numVertices = GraphCSRGetNumVertices(adjacencias);
+    partilhado.fimOrigens = matriz != NULL ? primeira + GraphDistanceMatrixGetNumRows(matriz) : partilhado.numVertices;
+    partilhado.origensPorBloco = multiFonte ? GRAPH_MSBFS_MAX_SOURCES : ORIGENS_POR_BLOCO_BF;
+    atomic_init(&partilhado.proximaOrigem, primeira);
+    atomic_init(&partilhado.cicloNegativo, 0);
+
+    unsigned int numOrigens = partilhado.fimOrigens - primeira;
+    unsigned int numBlocos = (numOrigens + partilhado.origensPorBloco - 1) / partilhado.origensPorBloco;
+    unsigned int numThreads = NumeroThreads(threadsPedidas, numBlocos);
+
+    Trabalhador* trabalhadores = (Trabalhador*)malloc(numThreads * sizeof(Trabalhador));
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (trabalhadores == NULL || threads == NULL) abort();
+
+    for (unsigned int t = 0; t < numThreads; t++) {
+        trabalhadores[t].partilhado = &partilhado;
+        trabalhadores[t].espaco = NULL;
+        trabalhadores[t].bfs = multiFonte ? GraphMSBFSCreate(adjacencias) : NULL;
+        trabalhadores[t].dijkstra = johnson != NULL ? GraphJohnsonSearchCreate(johnson) : NULL;
+    }
+
+    // A thread atual também trabalha, como trabalhador 0
+    for (unsigned int t = 1; t < numThreads; t++) {
+        if (pthread_create(&threads[t], NULL, ExecutarTrabalhador, &trabalhadores[t]) != 0) abort();
+    }
+    ExecutarTrabalhador(&trabalhadores[0]);
+    for (unsigned int t = 1; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    for (unsigned int t = 0; t < numThreads; t++) {
+        if (trabalhadores[t].espaco != NULL) GraphBellmanFordAlgWorkspaceDestroy(&trabalhadores[t].espaco);
+        if (trabalhadores[t].bfs != NULL) GraphMSBFSDestroy(&trabalhadores[t].bfs);
+        if (trabalhadores[t].dijkstra != NULL) GraphJohnsonSearchDestroy(&trabalhadores[t].dijkstra);
+    }
+    free(threads);
+    free(trabalhadores);
+
+    return !atomic_load(&partilhado.cicloNegativo);
+}
+
+// Floyd-Warshall por blocos, para grafos densos
+// Devolve 0 se houver um ciclo negativo
+static int ProcessarDistanciasFloydWarshall(const GraphCSR* adjacencias, GraphDistanceMatrix* matriz, unsigned int threadsPedidas) {
+    unsigned int numVertices = GraphCSRGetNumVertices(adjacencias);
+    GraphFloydWarshall* fw = GraphFloydWarshallExecute(adjacencias, NumeroThreads(threadsPedidas, numVertices));
+
+    int semCiclos = !GraphFloydWarshallHasNegativeCycle(fw);
+    for (unsigned int origem = 0; semCiclos && origem < numVertices; origem++) {
+        GuardarLinha(matriz, origem, GraphFloydWarshallGetRow(fw, origem), numVertices);
+    }
+
+    GraphFloydWarshallDestroy(&fw);
+    return semCiclos;
+}
+
+GraphAllPairsShortestDistancesOptions GraphAllPairsShortestDistancesDefaultOptions(void) {
+    GraphAllPairsShortestDistancesOptions opcoes;
+    opcoes.engine = GRAPH_APSD_ENGINE_AUTO;
+    opcoes.numThreads = 0;
+    opcoes.denseThreshold = 0.1;
+    return opcoes;
 }
 
-// Função principal para calcular as menores distâncias entre todos os pares de vértices
 GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecute(Graph* grafo) {
+    GraphAllPairsShortestDistancesOptions opcoes = GraphAllPairsShortestDistancesDefaultOptions();
+    return GraphAllPairsShortestDistancesExecuteWithOptions(grafo, &opcoes);
+}
+
+// Função principal para calcular as menores distâncias entre todos os pares de vértices
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecuteWithOptions(
+    Graph* grafo, const GraphAllPairsShortestDistancesOptions* opcoes) {
     assert(grafo != NULL);
+    assert(opcoes != NULL);
+
+    unsigned int numVertices = GraphGetNumVertices(grafo);
+    GraphCSR* adjacencias = GraphCSRCreate(grafo);
+
+    // Escolha do algoritmo: as distâncias em número de arestas de um grafo
+    // sem pesos são calculadas pela BFS multi-fonte; num grafo com pesos,
+    // o Floyd-Warshall, O(V^3), é preferível quando há muitas arestas; com
+    // poucas, o algoritmo de Johnson, O(V E log V)
+    GraphAllPairsShortestDistancesEngine motor = opcoes->engine;
+    if (motor == GRAPH_APSD_ENGINE_AUTO) {
+        double densidade = (double)GraphCSRGetNumArcs(adjacencias) / ((double)numVertices * numVertices);
+        if (!GraphIsWeighted(grafo)) {
+            motor = GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS;
+        } else if (densidade >= opcoes->denseThreshold) {
+            motor = GRAPH_APSD_ENGINE_FLOYD_WARSHALL;
+        } else {
+            motor = GRAPH_APSD_ENGINE_JOHNSON;
+        }
+    }
+    assert(motor != GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS || GraphIsWeighted(grafo) == 0);
 
     // Aloca memória para a estrutura principal
     GraphAllPairsShortestDistances* resultado = 
         (GraphAllPairsShortestDistances*)malloc(sizeof(GraphAllPairsShortestDistances));
-    if (resultado == NULL) return NULL;
+    if (resultado == NULL) {
+        GraphCSRDestroy(&adjacencias);
+        return NULL;
+    }
+
+    resultado->graph = grafo;
+    resultado->distance = NULL;
+    resultado->blocos = NULL;
+    resultado->cache = NULL;
+    resultado->maxCacheBytes = 0;
+    resultado->adjacencias = NULL;
+    resultado->espaco = NULL;
+    resultado->johnson = NULL;
+    resultado->dijkstra = NULL;
+
+    // Inicializa a matriz de distâncias: com pesos, valores reais; sem
+    // pesos, a largura das entradas é escolhida a partir do limite do
+    // diâmetro
+    // Num grafo não orientado, d(v, w) = d(w, v): apenas o triângulo
+    // superior é guardado
+    int comPesos = GraphIsWeighted(grafo);
+    int simetrica = !GraphIsDigraph(grafo);
+    unsigned int limite = comPesos ? 0 : LimiteDiametro(adjacencias);
+
+    // Com muitas componentes fortemente conexas, a maioria dos pares não
+    // tem caminho: a matriz é guardada por blocos, se ocupar no máximo
+    // metade da memória (exceto para o Floyd-Warshall, que usa a matriz
+    // completa)
+    if (motor != GRAPH_APSD_ENGINE_FLOYD_WARSHALL) {
+        size_t entradas = simetrica ? (size_t)numVertices * (numVertices + 1) / 2 : (size_t)numVertices * numVertices;
+        size_t bytesEntrada = comPesos ? sizeof(double) : GraphDistanceMatrixEntryBytesFor(limite);
+        resultado->blocos = CriarMatrizBlocos(adjacencias, comPesos, limite, entradas * bytesEntrada / 2);
+    }
+    if (resultado->blocos == NULL) {
+        if (comPesos) {
+            resultado->distance = simetrica ? GraphDistanceMatrixCreateWeightedSymmetric(numVertices)
+                                            : GraphDistanceMatrixCreateWeighted(numVertices);
+        } else {
+            resultado->distance = simetrica ? GraphDistanceMatrixCreateSymmetric(numVertices, limite)
+                                            : GraphDistanceMatrixCreate(numVertices, limite);
+        }
+    }
+
+    int semCiclos;
+    if (motor == GRAPH_APSD_ENGINE_FLOYD_WARSHALL) {
+        semCiclos = ProcessarDistanciasFloydWarshall(adjacencias, resultado->distance, opcoes->numThreads);
+    } else if (motor == GRAPH_APSD_ENGINE_JOHNSON) {
+        // Os potenciais são calculados uma única vez, e revelam os ciclos
+        // negativos
+        GraphJohnson* johnson = GraphJohnsonCreate(adjacencias);
+        semCiclos = johnson != NULL;
+        if (semCiclos) {
+            semCiclos = ProcessarDistanciasParalelo(grafo, adjacencias, johnson, resultado->distance, resultado->blocos, motor, opcoes->numThreads);
+            GraphJohnsonDestroy(&johnson);
+        }
+    } else {
+        // Processa as distâncias para cada vértice
+        semCiclos = ProcessarDistanciasParalelo(grafo, adjacencias, NULL, resultado->distance, resultado->blocos, motor, opcoes->numThreads);
+    }
+    GraphCSRDestroy(&adjacencias);
+
+    // Com um ciclo negativo, há distâncias indefinidas
+    if (!semCiclos) {
+        GraphAllPairsShortestDistancesDestroy(&resultado);
+    }
+
+    return resultado;
+}
+
+// Cálculo a pedido
+// Cada linha é calculada na primeira consulta, por uma execução de
+// Bellman-Ford (sem pesos) ou de Dijkstra (com pesos, depois da
+// repesagem de Johnson), e guardada numa cache LRU de tamanho limitado
+
+// Calcula a linha de uma origem, para a cache
+static void CalcularLinha(void* contexto, unsigned int origem, GraphDistanceMatrix* linhas, unsigned int linha) {
+    GraphAllPairsShortestDistances* resultado = (GraphAllPairsShortestDistances*)contexto;
+    unsigned int numVertices = GraphGetNumVertices(resultado->graph);
+
+    if (resultado->dijkstra != NULL) {
+        GuardarLinha(linhas, linha, GraphJohnsonSearchRun(resultado->dijkstra, origem), numVertices);
+    } else {
+        // Sem pesos, não há ciclos negativos
+        int semCiclos = ProcessarDistanciasVertice(resultado->espaco, linhas, linha, origem, numVertices);
+        assert(semCiclos);
+        (void)semCiclos;
+    }
+}
+
+// Liberta o que calcula as linhas, e as linhas guardadas
+static void LibertarCalculoAPedido(GraphAllPairsShortestDistances* resultado) {
+    if (resultado->cache != NULL) GraphDistanceRowCacheDestroy(&resultado->cache);
+    if (resultado->espaco != NULL) GraphBellmanFordAlgWorkspaceDestroy(&resultado->espaco);
+    if (resultado->adjacencias != NULL) GraphCSRDestroy(&resultado->adjacencias);
+    if (resultado->dijkstra != NULL) GraphJohnsonSearchDestroy(&resultado->dijkstra);
+    if (resultado->johnson != NULL) GraphJohnsonDestroy(&resultado->johnson);
+}
+
+// Prepara o cálculo das linhas, a partir do estado atual do grafo
+// Devolve 0 se o grafo tiver um ciclo negativo
+static int IniciarCalculoAPedido(GraphAllPairsShortestDistances* resultado) {
+    Graph* grafo = resultado->graph;
+    resultado->adjacencias = GraphCSRCreate(grafo);
+
+    unsigned int limite = 0;
+    if (GraphIsWeighted(grafo)) {
+        // Os potenciais revelam os ciclos negativos
+        resultado->johnson = GraphJohnsonCreate(resultado->adjacencias);
+        if (resultado->johnson == NULL) return 0;
+        resultado->dijkstra = GraphJohnsonSearchCreate(resultado->johnson);
+    } else {
+        resultado->espaco = GraphBellmanFordAlgWorkspaceCreateShared(grafo, resultado->adjacencias);
+        limite = LimiteDiametro(resultado->adjacencias);
+    }
+
+    resultado->cache = GraphDistanceRowCacheCreate(GraphGetNumVertices(grafo), GraphIsWeighted(grafo), limite,
+                                                   resultado->maxCacheBytes, CalcularLinha, resultado);
+    return 1;
+}
+
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesCreateLazy(
+    Graph* grafo, size_t maxMemoryBytes) {
+    assert(grafo != NULL);
+
+    GraphAllPairsShortestDistances* resultado =
+        (GraphAllPairsShortestDistances*)malloc(sizeof(GraphAllPairsShortestDistances));
+    if (resultado == NULL) abort();
 
     resultado->graph = grafo;
+    resultado->distance = NULL;
+    resultado->blocos = NULL;
+    resultado->cache = NULL;
+    resultado->maxCacheBytes = maxMemoryBytes;
+    resultado->adjacencias = NULL;
+    resultado->espaco = NULL;
+    resultado->johnson = NULL;
+    resultado->dijkstra = NULL;
+
+    if (!IniciarCalculoAPedido(resultado)) {
+        GraphAllPairsShortestDistancesDestroy(&resultado);
+    }
+
+    return resultado;
+}
+
+// Cálculo para um ficheiro
+// As linhas são calculadas por janelas de linhas consecutivas, que cabem
+// no limite de memória, e cada janela é escrita no seu lugar do ficheiro;
+// no fim, o ficheiro é mapeado em memória, apenas para leitura, e as
+// consultas leem a matriz diretamente do mapeamento
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecuteToFile(
+    Graph* grafo, const char* caminho, size_t maxMemoryBytes,
+    const GraphAllPairsShortestDistancesOptions* opcoes) {
+    assert(grafo != NULL);
+    assert(caminho != NULL);
+    assert(opcoes != NULL);
+    // O Floyd-Warshall precisa da matriz inteira em memória
+    assert(opcoes->engine != GRAPH_APSD_ENGINE_FLOYD_WARSHALL);
+
+    int comPesos = GraphIsWeighted(grafo);
+    GraphAllPairsShortestDistancesEngine motor = opcoes->engine;
+    if (motor == GRAPH_APSD_ENGINE_AUTO) {
+        motor = comPesos ? GRAPH_APSD_ENGINE_JOHNSON : GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS;
+    }
+    assert(motor != GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS || comPesos == 0);
+
+    int descritor = open(caminho, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (descritor < 0) return NULL;
+
     unsigned int numVertices = GraphGetNumVertices(grafo);
+    GraphCSR* adjacencias = GraphCSRCreate(grafo);
+    unsigned int limite = comPesos ? 0 : LimiteDiametro(adjacencias);
+    unsigned int bytesEntrada = comPesos ? sizeof(double) : GraphDistanceMatrixEntryBytesFor(limite);
 
-    // Inicializa a matriz de distâncias
-    resultado->distance = InicializarMatrizDistancias(numVertices);
-    if (resultado->distance == NULL) {
-        free(resultado);
-        return NULL;
+    // Linhas por janela: tantas quantas cabem no limite de memória, mas
+    // pelo menos uma; a BFS multi-fonte prefere lotes completos
+    size_t bytesLinha = (size_t)numVertices * bytesEntrada;
+    size_t linhasPorJanela = bytesLinha > 0 ? maxMemoryBytes / bytesLinha : 1;
+    if (linhasPorJanela > numVertices) linhasPorJanela = numVertices;
+    if (motor == GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS && linhasPorJanela > GRAPH_MSBFS_MAX_SOURCES) {
+        linhasPorJanela -= linhasPorJanela % GRAPH_MSBFS_MAX_SOURCES;
     }
+    if (linhasPorJanela == 0) linhasPorJanela = 1;
 
-    // Processa as distâncias para cada vértice
-    for (unsigned int origem = 0; origem < numVertices; origem++) {
-        ProcessarDistanciasVertice(grafo, resultado->distance, origem, numVertices);
+    GraphDistanceMatrix* janela = comPesos
+        ? GraphDistanceMatrixCreateWeightedRows((unsigned int)linhasPorJanela, numVertices)
+        : GraphDistanceMatrixCreateRows((unsigned int)linhasPorJanela, numVertices, limite);
+
+    GraphJohnson* johnson = NULL;
+    int semCiclos = 1;
+    if (motor == GRAPH_APSD_ENGINE_JOHNSON) {
+        johnson = GraphJohnsonCreate(adjacencias);
+        semCiclos = johnson != NULL;
+    }
+
+    int escrito = 1;
+    for (unsigned int primeira = 0; semCiclos && escrito && primeira < numVertices; primeira += (unsigned int)linhasPorJanela) {
+        // A última janela é recuada até ao fim da matriz: algumas linhas
+        // são calculadas duas vezes, com o mesmo resultado
+        unsigned int inicio = primeira;
+        if (inicio > numVertices - linhasPorJanela) inicio = numVertices - (unsigned int)linhasPorJanela;
+
+        GraphDistanceMatrixSetFirstRow(janela, inicio);
+        for (unsigned int linha = inicio; linha < inicio + linhasPorJanela; linha++) {
+            GraphDistanceMatrixClearRow(janela, linha);
+        }
+        semCiclos = ProcessarDistanciasParalelo(grafo, adjacencias, johnson, janela, NULL, motor, opcoes->numThreads);
+        if (semCiclos) escrito = GraphDistanceMatrixWriteRows(janela, descritor);
     }
 
+    if (johnson != NULL) GraphJohnsonDestroy(&johnson);
+    GraphDistanceMatrixDestroy(&janela);
+    GraphCSRDestroy(&adjacencias);
+
+    GraphDistanceMatrix* matriz = NULL;
+    if (semCiclos && escrito) {
+        matriz = GraphDistanceMatrixMapFile(descritor, numVertices, bytesEntrada, limite);
+    }
+    close(descritor);
+    // Com um ciclo negativo, ou uma falha de escrita, não há resultado
+    if (matriz == NULL) {
+        unlink(caminho);
+        return NULL;
+    }
+
+    GraphAllPairsShortestDistances* resultado =
+        (GraphAllPairsShortestDistances*)malloc(sizeof(GraphAllPairsShortestDistances));
+    if (resultado == NULL) abort();
+
+    resultado->distance = matriz;
+    resultado->blocos = NULL;
+    resultado->graph = grafo;
+    resultado->cache = NULL;
+    resultado->maxCacheBytes = 0;
+    resultado->adjacencias = NULL;
+    resultado->espaco = NULL;
+    resultado->johnson = NULL;
+    resultado->dijkstra = NULL;
+
     return resultado;
 }
 
+// Atualização após a inserção de arestas
+// Um caminho mais curto usa uma nova aresta (u, v) no máximo uma vez: a
+// nova distância de x a y é min(d(x, y), d(x, u) + peso + d(v, y)). Sem
+// ciclos negativos, a aresta não encurta d(x, u) nem d(v, y), que podem
+// ser lidas antes da atualização. O(V^2) por aresta, em vez de um novo
+// cálculo completo.
+
+// Peso da aresta (u, v) do grafo (1, sem pesos)
+static double PesoAresta(const Graph* grafo, unsigned int u, unsigned int v) {
+    if (!GraphIsWeighted(grafo)) return 1.0;
+
+    unsigned int* adjacentes = GraphGetAdjacentsTo(grafo, u);
+    double* pesos = GraphGetDistancesToAdjacents(grafo, u);
+    double peso = INFINITY;
+    for (unsigned int i = 1; i <= adjacentes[0]; i++) {
+        if (adjacentes[i] == v) {
+            peso = pesos[i];
+            break;
+        }
+    }
+    free(adjacentes);
+    free(pesos);
+
+    // A aresta já tem de estar no grafo
+    assert(peso != INFINITY);
+    return peso;
+}
+
+// Escreve a distância de x a y; por blocos, y tem de ser alcançável
+static void EscreverDistancia(GraphAllPairsShortestDistances* p, unsigned int x, unsigned int y, double distancia) {
+    GraphDistanceMatrix* matriz = p->distance;
+    unsigned int linha = x;
+    unsigned int coluna = y;
+    if (p->blocos != NULL) {
+        unsigned int c = GraphSCCGetComponent(p->blocos->componentes, x);
+        matriz = p->blocos->blocos[c];
+        linha = GraphSCCGetIndexInComponent(p->blocos->componentes, x);
+        coluna = ColunaBloco(p->blocos, c, y);
+        assert(coluna != UINT_MAX);
+    }
+
+    if (GraphDistanceMatrixIsWeighted(matriz)) {
+        GraphDistanceMatrixSetWeighted(matriz, linha, coluna, distancia);
+    } else {
+        GraphDistanceMatrixSet(matriz, linha, coluna, (int)distancia);
+    }
+}
+
+// Limite das distâncias das entradas, sem pesos
+static unsigned int LimiteEntradas(const GraphAllPairsShortestDistances* p) {
+    if (p->blocos != NULL) return GraphDistanceMatrixGetMaxDistance(p->blocos->blocos[0]);
+    return GraphDistanceMatrixGetMaxDistance(p->distance);
+}
+
+// Os blocos não têm lugar para os pares que passam a ter caminho: são
+// recriados, a partir das componentes do grafo atual, e as distâncias
+// conhecidas são copiadas
+// minimo: limite mínimo das distâncias, sem pesos; numa sequência de
+// inserções, as distâncias intermédias podem exceder o limite do diâmetro
+// do grafo final
+static void ReorganizarBlocos(GraphAllPairsShortestDistances* p, unsigned int minimo) {
+    GraphCSR* adjacencias = GraphCSRCreate(p->graph);
+    int comPesos = GraphIsWeighted(p->graph);
+    unsigned int limite = comPesos ? 0 : LimiteDiametro(adjacencias);
+    if (limite < minimo) limite = minimo;
+    unsigned int numVertices = GraphCSRGetNumVertices(adjacencias);
+
+    MatrizBlocos* antigos = p->blocos;
+    p->blocos = CriarMatrizBlocos(adjacencias, comPesos, limite, SIZE_MAX);
+    if (p->blocos == NULL) {
+        // Uma só componente: a matriz completa
+        int simetrica = !GraphIsDigraph(p->graph);
+        if (comPesos) {
+            p->distance = simetrica ? GraphDistanceMatrixCreateWeightedSymmetric(numVertices)
+                                    : GraphDistanceMatrixCreateWeighted(numVertices);
+        } else {
+            p->distance = simetrica ? GraphDistanceMatrixCreateSymmetric(numVertices, limite)
+                                    : GraphDistanceMatrixCreate(numVertices, limite);
+        }
+    }
+    GraphCSRDestroy(&adjacencias);
+
+    unsigned int numComponentes = GraphSCCGetNumComponents(antigos->componentes);
+    const unsigned int* inicioComponente = GraphSCCGetComponentOffsets(antigos->componentes);
+    const unsigned int* vertices = GraphSCCGetVertices(antigos->componentes);
+    for (unsigned int c = 0; c < numComponentes; c++) {
+        for (unsigned int i = inicioComponente[c]; i < inicioComponente[c + 1]; i++) {
+            unsigned int x = vertices[i];
+            unsigned int linha = i - inicioComponente[c];
+            PARA_CADA_COLUNA(antigos, c, coluna, y, {
+                double distancia = GraphDistanceMatrixGetWeighted(antigos->blocos[c], linha, coluna);
+                if (distancia != INFINITY) EscreverDistancia(p, x, y, distancia);
+            });
+        }
+    }
+    DestruirMatrizBlocos(&antigos);
+}
+
+// A matriz passa a admitir as distâncias até ao limite do diâmetro do
+// grafo atual, e pelo menos até minimo: num grafo não orientado, a
+// inserção pode juntar componentes
+static void AlargarMatriz(GraphAllPairsShortestDistances* p, unsigned int minimo) {
+    GraphCSR* adjacencias = GraphCSRCreate(p->graph);
+    unsigned int limite = LimiteDiametro(adjacencias);
+    GraphCSRDestroy(&adjacencias);
+    if (limite < minimo) limite = minimo;
+
+    GraphDistanceMatrix* antiga = p->distance;
+    unsigned int numVertices = GraphDistanceMatrixGetNumVertices(antiga);
+    int simetrica = GraphDistanceMatrixIsSymmetric(antiga);
+    p->distance = simetrica ? GraphDistanceMatrixCreateSymmetric(numVertices, limite)
+                            : GraphDistanceMatrixCreate(numVertices, limite);
+    for (unsigned int x = 0; x < numVertices; x++) {
+        for (unsigned int y = simetrica ? x : 0; y < numVertices; y++) {
+            int distancia = GraphDistanceMatrixGet(antiga, x, y);
+            if (distancia != GRAPH_DISTANCE_UNREACHABLE) GraphDistanceMatrixSet(p->distance, x, y, distancia);
+        }
+    }
+    GraphDistanceMatrixDestroy(&antiga);
+}
+
+// 1 se só o triângulo superior da matriz estiver guardado
+static int MatrizSimetrica(const GraphAllPairsShortestDistances* p) {
+    return p->distance != NULL && GraphDistanceMatrixIsSymmetric(p->distance);
+}
+
+// Atualiza as distâncias após a inserção do arco (u, v), já no grafo
+// paraU e deV: espaço para V distâncias
+// Devolve 0 se o arco fechar um ciclo negativo
+// Com a matriz simétrica, a aresta é usada nos dois sentidos: o par {x, y}
+// é escrito uma só vez, com o melhor de x -> u -> v -> y e y -> u -> v -> x,
+// que tem o comprimento de x -> v -> u -> y
+static int InserirArco(GraphAllPairsShortestDistances* p, unsigned int u, unsigned int v, double* paraU, double* deV) {
+    unsigned int numVertices = GraphGetNumVertices(p->graph);
+    double peso = PesoAresta(p->graph, u, v);
+    if (GraphGetWeightedDistanceVW(p, v, u) + peso < 0.0) return 0;
+
+    double maiorParaU = 0.0;
+    double maiorDeV = 0.0;
+    for (unsigned int x = 0; x < numVertices; x++) {
+        paraU[x] = GraphGetWeightedDistanceVW(p, x, u);
+        deV[x] = GraphGetWeightedDistanceVW(p, v, x);
+        if (paraU[x] != INFINITY && paraU[x] > maiorParaU) maiorParaU = paraU[x];
+        if (deV[x] != INFINITY && deV[x] > maiorDeV) maiorDeV = deV[x];
+    }
+
+    // As novas distâncias, sem pesos, têm de caber nas entradas; nenhuma
+    // excede V - 1
+    unsigned int minimo = 0;
+    double maiorNova = maiorParaU + peso + maiorDeV;
+    if (!GraphIsWeighted(p->graph) && maiorNova > (double)LimiteEntradas(p)) {
+        minimo = maiorNova < (double)(numVertices - 1) ? (unsigned int)maiorNova : numVertices - 1;
+    }
+
+    // Os pares (x, y) com x -> u e v -> y passam a ter caminho
+    if (p->blocos != NULL &&
+        (minimo > 0 ||
+         ColunaBloco(p->blocos, GraphSCCGetComponent(p->blocos->componentes, u), v) == UINT_MAX)) {
+        ReorganizarBlocos(p, minimo);
+    } else if (p->distance != NULL && minimo > 0) {
+        AlargarMatriz(p, minimo);
+    }
+
+    if (MatrizSimetrica(p)) {
+        for (unsigned int x = 0; x < numVertices; x++) {
+            if (paraU[x] == INFINITY && deV[x] == INFINITY) continue;
+            for (unsigned int y = x; y < numVertices; y++) {
+                double direto = paraU[x] + deV[y];
+                double inverso = paraU[y] + deV[x];
+                double distancia = (direto < inverso ? direto : inverso) + peso;
+                if (distancia < GraphGetWeightedDistanceVW(p, x, y)) EscreverDistancia(p, x, y, distancia);
+            }
+        }
+        return 1;
+    }
+
+    for (unsigned int x = 0; x < numVertices; x++) {
+        if (paraU[x] == INFINITY) continue;
+        for (unsigned int y = 0; y < numVertices; y++) {
+            if (deV[y] == INFINITY) continue;
+            double distancia = paraU[x] + peso + deV[y];
+            if (distancia < GraphGetWeightedDistanceVW(p, x, y)) EscreverDistancia(p, x, y, distancia);
+        }
+    }
+    return 1;
+}
+
+int GraphAllPairsShortestDistancesAddEdges(GraphAllPairsShortestDistances* p,
+                                           const unsigned int* tails,
+                                           const unsigned int* heads,
+                                           unsigned int numEdges) {
+    assert(p != NULL);
+    assert(numEdges == 0 || (tails != NULL && heads != NULL));
+    assert(p->distance == NULL || !GraphDistanceMatrixIsMapped(p->distance));
+
+    // A pedido: as linhas guardadas são descartadas, e o cálculo é
+    // preparado de novo, para o grafo atual
+    if (p->cache != NULL) {
+        LibertarCalculoAPedido(p);
+        return IniciarCalculoAPedido(p);
+    }
+
+    unsigned int numVertices = GraphGetNumVertices(p->graph);
+    double* paraU = (double*)malloc((numVertices + 1) * sizeof(double));
+    double* deV = (double*)malloc((numVertices + 1) * sizeof(double));
+    if (paraU == NULL || deV == NULL) abort();
+
+    int semCiclos = 1;
+    for (unsigned int i = 0; semCiclos && i < numEdges; i++) {
+        assert(tails[i] < numVertices && heads[i] < numVertices);
+        if (GraphIsDigraph(p->graph)) {
+            semCiclos = InserirArco(p, tails[i], heads[i], paraU, deV);
+        } else {
+            // Uma aresta com peso negativo é, por si, um ciclo negativo
+            // A matriz simétrica recebe os dois sentidos de uma só vez
+            semCiclos = PesoAresta(p->graph, tails[i], heads[i]) >= 0.0 &&
+                        InserirArco(p, tails[i], heads[i], paraU, deV) &&
+                        (MatrizSimetrica(p) || InserirArco(p, heads[i], tails[i], paraU, deV));
+        }
+    }
+
+    free(paraU);
+    free(deV);
+    return semCiclos;
+}
+
+int GraphAllPairsShortestDistancesAddEdge(GraphAllPairsShortestDistances* p,
+                                          unsigned int u, unsigned int v) {
+    return GraphAllPairsShortestDistancesAddEdges(p, &u, &v, 1);
+}
+
 void GraphAllPairsShortestDistancesDestroy(GraphAllPairsShortestDistances** p) {
   assert(*p != NULL);
 
   GraphAllPairsShortestDistances* aux = *p;
-  unsigned int numVertices = GraphGetNumVertices(aux->graph);
-
-  for (unsigned int i = 0; i < numVertices; i++) {
-    free(aux->distance[i]);
+  if (aux->distance != NULL) {
+    GraphDistanceMatrixDestroy(&aux->distance);
   }
-
-  free(aux->distance);
+  if (aux->blocos != NULL) {
+    DestruirMatrizBlocos(&aux->blocos);
+  }
+  LibertarCalculoAPedido(aux);
 
   free(*p);
   *p = NULL;
 }
 
+// Consultas em lote
+// Numa matriz em memória, os pares são lidos pela sua ordem, sem uma
+// chamada por par: agrupá-los por linha custa mais do que poupa. A pedido,
+// ou num ficheiro, são agrupados por origem: cada linha é calculada, ou
+// lida do disco, uma só vez por lote
+
+// Chave: a origem, e a posição do par no lote
+static int CompararChaves(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y);
+}
+
+// A permutação que agrupa os pares por origem, sem alterar a ordem dos
+// pares de cada origem: por contagem, se o lote for grande para o número
+// de vértices; senão, ordenando as chaves (origem, posição)
+static unsigned int* AgruparPorOrigem(const unsigned int* origens, unsigned int numPares,
+                                      unsigned int numVertices) {
+    unsigned int* ordem = (unsigned int*)malloc((numPares + 1) * sizeof(unsigned int));
+    if (ordem == NULL) abort();
+
+    if (numPares >= numVertices / 8) {
+        unsigned int* inicio = (unsigned int*)calloc(numVertices + 1, sizeof(unsigned int));
+        if (inicio == NULL) abort();
+        for (unsigned int i = 0; i < numPares; i++) inicio[origens[i] + 1]++;
+        for (unsigned int v = 0; v < numVertices; v++) inicio[v + 1] += inicio[v];
+        for (unsigned int i = 0; i < numPares; i++) ordem[inicio[origens[i]]++] = i;
+        free(inicio);
+        return ordem;
+    }
+
+    uint64_t* chaves = (uint64_t*)malloc((numPares + 1) * sizeof(uint64_t));
+    if (chaves == NULL) abort();
+    for (unsigned int i = 0; i < numPares; i++) chaves[i] = ((uint64_t)origens[i] << 32) | i;
+    qsort(chaves, numPares, sizeof(uint64_t), CompararChaves);
+    for (unsigned int i = 0; i < numPares; i++) ordem[i] = (unsigned int)chaves[i];
+    free(chaves);
+    return ordem;
+}
+
+// Uma das saídas é NULL: inteiras (sem pesos) ou reais
+static void ConsultarLote(const GraphAllPairsShortestDistances* p, const unsigned int* origens,
+                          const unsigned int* destinos, unsigned int numPares, int* inteiras,
+                          double* reais) {
+    unsigned int numVertices = GraphGetNumVertices(p->graph);
+
+    if (p->distance != NULL && !GraphDistanceMatrixIsMapped(p->distance)) {
+        if (inteiras != NULL) {
+            GraphDistanceMatrixGetEntries(p->distance, origens, destinos, numPares, inteiras);
+        } else {
+            GraphDistanceMatrixGetWeightedEntries(p->distance, origens, destinos, numPares, reais);
+        }
+        return;
+    }
+
+    if (p->blocos != NULL) {
+        for (unsigned int i = 0; i < numPares; i++) {
+            assert(origens[i] < numVertices && destinos[i] < numVertices);
+            double distancia = DistanciaBlocos(p->blocos, origens[i], destinos[i]);
+            if (inteiras != NULL) {
+                inteiras[i] = distancia == INFINITY ? -1 : (int)distancia;
+            } else {
+                reais[i] = distancia;
+            }
+        }
+        return;
+    }
+
+    for (unsigned int i = 0; i < numPares; i++) assert(origens[i] < numVertices);
+    unsigned int* ordem = AgruparPorOrigem(origens, numPares, numVertices);
+
+    // Os pares e as respostas, pela ordem dos grupos
+    unsigned int* linhas = (unsigned int*)malloc((numPares + 1) * sizeof(unsigned int));
+    unsigned int* colunas = (unsigned int*)malloc((numPares + 1) * sizeof(unsigned int));
+    int* inteirasAgrupadas = inteiras != NULL ? (int*)malloc((numPares + 1) * sizeof(int)) : NULL;
+    double* reaisAgrupadas = reais != NULL ? (double*)malloc((numPares + 1) * sizeof(double)) : NULL;
+    if (linhas == NULL || colunas == NULL || (inteirasAgrupadas == NULL && reaisAgrupadas == NULL)) {
+        abort();
+    }
+    for (unsigned int k = 0; k < numPares; k++) colunas[k] = destinos[ordem[k]];
+
+    unsigned int k = 0;
+    while (k < numPares) {
+        unsigned int v = origens[ordem[k]];
+        unsigned int fim = k + 1;
+        while (fim < numPares && origens[ordem[fim]] == v) fim++;
+
+        // A linha de uma cache só é válida até à próxima procura
+        const GraphDistanceMatrix* matriz = p->distance;
+        unsigned int linha = v;
+        if (p->cache != NULL) {
+            linha = GraphDistanceRowCacheLookup(p->cache, v);
+            matriz = GraphDistanceRowCacheGetRows(p->cache);
+        }
+        for (unsigned int i = k; i < fim; i++) linhas[i] = linha;
+        if (inteiras != NULL) {
+            GraphDistanceMatrixGetEntries(matriz, linhas + k, colunas + k, fim - k, inteirasAgrupadas + k);
+        } else {
+            GraphDistanceMatrixGetWeightedEntries(matriz, linhas + k, colunas + k, fim - k, reaisAgrupadas + k);
+        }
+        k = fim;
+    }
+
+    for (unsigned int i = 0; i < numPares; i++) {
+        if (inteiras != NULL) {
+            inteiras[ordem[i]] = inteirasAgrupadas[i];
+        } else {
+            reais[ordem[i]] = reaisAgrupadas[i];
+        }
+    }
+
+    free(ordem);
+    free(linhas);
+    free(colunas);
+    free(inteirasAgrupadas);
+    free(reaisAgrupadas);
+}
+
 // Getting the result
 
 int GraphGetDistanceVW(const GraphAllPairsShortestDistances* p, unsigned int v,
@@ -125,8 +1227,77 @@ int GraphGetDistanceVW(const GraphAllPairsShortestDistances* p, unsigned int v,
   assert(p != NULL);
   assert(v < GraphGetNumVertices(p->graph));
   assert(w < GraphGetNumVertices(p->graph));
+  assert(GraphIsWeighted(p->graph) == 0);
+
+  if (p->cache != NULL) {
+    unsigned int row = GraphDistanceRowCacheLookup(p->cache, v);
+    return GraphDistanceMatrixGet(GraphDistanceRowCacheGetRows(p->cache), row, w);
+  }
+  if (p->blocos != NULL) {
+    double distance = DistanciaBlocos(p->blocos, v, w);
+    return distance == INFINITY ? -1 : (int)distance;
+  }
+  return GraphDistanceMatrixGet(p->distance, v, w);
+}
+
+double GraphGetWeightedDistanceVW(const GraphAllPairsShortestDistances* p,
+                                  unsigned int v, unsigned int w) {
+  assert(p != NULL);
+  assert(v < GraphGetNumVertices(p->graph));
+  assert(w < GraphGetNumVertices(p->graph));
+
+  if (p->cache != NULL) {
+    unsigned int row = GraphDistanceRowCacheLookup(p->cache, v);
+    return GraphDistanceMatrixGetWeighted(GraphDistanceRowCacheGetRows(p->cache), row, w);
+  }
+  if (p->blocos != NULL) {
+    return DistanciaBlocos(p->blocos, v, w);
+  }
+  return GraphDistanceMatrixGetWeighted(p->distance, v, w);
+}
+
+void GraphGetDistancesVW(const GraphAllPairsShortestDistances* p,
+                         const unsigned int* sources,
+                         const unsigned int* targets, unsigned int numPairs,
+                         int* distances) {
+  assert(p != NULL);
+  assert(numPairs == 0 ||
+         (sources != NULL && targets != NULL && distances != NULL));
+  assert(GraphIsWeighted(p->graph) == 0);
+
+  ConsultarLote(p, sources, targets, numPairs, distances, NULL);
+}
+
+void GraphGetWeightedDistancesVW(const GraphAllPairsShortestDistances* p,
+                                 const unsigned int* sources,
+                                 const unsigned int* targets,
+                                 unsigned int numPairs, double* distances) {
+  assert(p != NULL);
+  assert(numPairs == 0 ||
+         (sources != NULL && targets != NULL && distances != NULL));
+
+  ConsultarLote(p, sources, targets, numPairs, NULL, distances);
+}
+
+size_t GraphAllPairsShortestDistancesGetMemoryBytes(
+    const GraphAllPairsShortestDistances* p) {
+  assert(p != NULL);
+
+  if (p->cache != NULL) {
+    return GraphDistanceRowCacheGetStats(p->cache).memoryBytes;
+  }
+  if (p->blocos != NULL) {
+    return p->blocos->numBytes;
+  }
+  return GraphDistanceMatrixGetMemoryBytes(p->distance);
+}
+
+GraphDistanceRowCacheStats GraphAllPairsShortestDistancesGetCacheStats(
+    const GraphAllPairsShortestDistances* p) {
+  assert(p != NULL);
+  assert(p->cache != NULL);
 
-  return p->distance[v][w];
+  return GraphDistanceRowCacheGetStats(p->cache);
 }
 
 // DISPLAYING on the console
@@ -140,12 +1311,14 @@ void GraphAllPairsShortestDistancesPrint(
 
   for (unsigned int i = 0; i < numVertices; i++) {
     for (unsigned int j = 0; j < numVertices; j++) {
-      int distanceIJ = p->distance[i][j];
-      if (distanceIJ == -1) {
+      double distanceIJ = GraphGetWeightedDistanceVW(p, i, j);
+      if (distanceIJ == INFINITY) {
         // INFINITY - j was not reached from i
-        printf(" INF");
+        printf(GraphIsWeighted(p->graph) ? "     INF" : " INF");
+      } else if (GraphIsWeighted(p->graph)) {
+        printf(" %7.2f", distanceIJ);
       } else {
-        printf(" %3d", distanceIJ);
+        printf(" %3d", (int)distanceIJ);
       }
     }
     printf("\n");
@@ -9,19 +9,141 @@
 #ifndef _GRAPH_ALL_PAIRS_SHORTEST_DISTANCES_
 #define _GRAPH_ALL_PAIRS_SHORTEST_DISTANCES_
 
+#include <stddef.h>
+
 #include "Graph.h"
+#include "GraphDistanceRowCache.h"
 
 typedef struct _GraphAllPairsShortestDistances GraphAllPairsShortestDistances;
 
+// The algorithm used to fill the distance matrix
+
+typedef enum {
+  GRAPH_APSD_ENGINE_AUTO,          // Chosen from the graph properties
+  GRAPH_APSD_ENGINE_BELLMAN_FORD,  // One Bellman-Ford run per source vertex
+  GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS,  // Bit-parallel BFS, many sources
+                                       // at a time (unweighted graphs)
+  GRAPH_APSD_ENGINE_FLOYD_WARSHALL,  // Blocked Floyd-Warshall, O(V^3)
+                                     // AUTO uses it for dense weighted graphs
+  GRAPH_APSD_ENGINE_JOHNSON  // One Bellman-Ford run, for reweighting, then
+                             // one Dijkstra run per source, O(V E log V)
+                             // AUTO uses it for sparse weighted graphs
+} GraphAllPairsShortestDistancesEngine;
+
+typedef struct {
+  GraphAllPairsShortestDistancesEngine engine;
+  // The source vertices are shared among numThreads threads (0: one per
+  // online processor); the matrix does not depend on the number of threads
+  unsigned int numThreads;
+  // AUTO uses Floyd-Warshall for weighted graphs with at least
+  // denseThreshold * V^2 arcs (default: 0.1)
+  double denseThreshold;
+} GraphAllPairsShortestDistancesOptions;
+
+GraphAllPairsShortestDistancesOptions GraphAllPairsShortestDistancesDefaultOptions(
+    void);
+
+// Weighted graphs may have negative weights
+// Returns NULL if the graph has a negative cycle
+// Undirected graphs: the matrix is symmetric, and only its upper triangle
+// is stored and filled
+// Graphs with many strongly connected components: if it halves the
+// memory, only the pairs (v, w) where the component of w is reachable from
+// the component of v are stored and filled, in one dense block per
+// component (except with Floyd-Warshall)
+
+// Uses the default options
 GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecute(Graph* g);
 
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecuteWithOptions(
+    Graph* g, const GraphAllPairsShortestDistancesOptions* options);
+
+//
+// On demand: row v, the distances from v, is computed when it is first
+// queried, and kept in an LRU cache of at most maxMemoryBytes (but at
+// least one row), for the following queries
+// Unweighted graphs: one Bellman-Ford run per row; weighted graphs: one
+// Dijkstra run per row, after Johnson's reweighting
+// Returns NULL if the graph has a negative cycle
+// The queries update the cache: not thread-safe
+// The graph must not change while the result is in use
+//
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesCreateLazy(
+    Graph* g, size_t maxMemoryBytes);
+
+//
+// Out of core: for matrices larger than memory
+// The rows are computed in windows of consecutive rows, of at most
+// maxMemoryBytes (but at least one row), and each window is written to its
+// place in the file at path; the file is then mapped read-only, and the
+// queries read it, the pages being loaded on demand
+// AUTO uses the multi-source BFS (unweighted) or Johnson's algorithm
+// (weighted); Floyd-Warshall cannot be used
+// Returns NULL if the graph has a negative cycle, or the file cannot be
+// written; the file is then removed
+// The file holds only the entries (see GraphDistanceMatrix), and is kept
+// after the result is destroyed
+//
+GraphAllPairsShortestDistances* GraphAllPairsShortestDistancesExecuteToFile(
+    Graph* g, const char* path, size_t maxMemoryBytes,
+    const GraphAllPairsShortestDistancesOptions* options);
+
 void GraphAllPairsShortestDistancesDestroy(GraphAllPairsShortestDistances** p);
 
+//
+// Repairs a result after new edges were added to its graph: edge i goes
+// from tails[i] to heads[i] (either way, for an undirected graph)
+// Each edge costs O(V^2): only the pairs whose shortest path can go
+// through it are examined, instead of computing every distance again
+// Results computed on demand drop their cached rows; results computed out
+// of core cannot be repaired
+// Returns 0 if the new edges close a negative cycle; the result is then no
+// longer valid and must be destroyed
+//
+int GraphAllPairsShortestDistancesAddEdges(GraphAllPairsShortestDistances* p,
+                                           const unsigned int* tails,
+                                           const unsigned int* heads,
+                                           unsigned int numEdges);
+
+// A single edge, from u to v
+int GraphAllPairsShortestDistancesAddEdge(GraphAllPairsShortestDistances* p,
+                                          unsigned int u, unsigned int v);
+
 // Getting the result
 
+// Unweighted graphs only: the number of edges, or -1 if w is not reachable
 int GraphGetDistanceVW(const GraphAllPairsShortestDistances* p, unsigned int v,
                        unsigned int w);
 
+// INFINITY if w is not reachable from v
+double GraphGetWeightedDistanceVW(const GraphAllPairsShortestDistances* p,
+                                  unsigned int v, unsigned int w);
+
+//
+// Batched queries: distances[i] is the distance from sources[i] to
+// targets[i], as above
+// A matrix in memory is read in a single loop, without a call per pair
+// Results computed on demand, or out of core, answer the pairs grouped by
+// source: each row is computed, or read from the file, once per batch
+//
+void GraphGetDistancesVW(const GraphAllPairsShortestDistances* p,
+                         const unsigned int* sources,
+                         const unsigned int* targets, unsigned int numPairs,
+                         int* distances);
+
+void GraphGetWeightedDistancesVW(const GraphAllPairsShortestDistances* p,
+                                 const unsigned int* sources,
+                                 const unsigned int* targets,
+                                 unsigned int numPairs, double* distances);
+
+// The memory held by the distances: the matrix, or the cached rows
+size_t GraphAllPairsShortestDistancesGetMemoryBytes(
+    const GraphAllPairsShortestDistances* p);
+
+// Results computed on demand only: cache hits, misses and evictions
+GraphDistanceRowCacheStats GraphAllPairsShortestDistancesGetCacheStats(
+    const GraphAllPairsShortestDistances* p);
+
 // DISPLAYING on the console
 
 void GraphAllPairsShortestDistancesPrint(
@@ -17,210 +17,792 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
-#include <time.h>
+#include <stdint.h>
+#include <math.h>
 
 #include "Graph.h"
+#include "GraphCSR.h"
+#include "GraphEdgeArrays.h"
+#include "GraphFrontier.h"
 
 #include "IntegersStack.h"
 #include "instrumentation.h"
 
 struct _GraphBellmanFordAlg {
   unsigned int* marked;  // To mark vertices when reached for the first time
-  int* distance;  // The number of edges on the path from the start vertex
-                  // distance[i]=-1, if no path found from the start vertex to i
+                         // v was reached iff marked[v] == epoch
+  double* distance;  // The length of the path from the start vertex
+                     // (the number of edges, if the graph is unweighted)
+                     // Only meaningful for the reached vertices
   int* predecessor;  // The predecessor vertex in the shortest path
                      // predecessor[i]=-1, if no predecessor exists
+                     // NULL, if the predecessors were not tracked
   Graph* graph;
   unsigned int startVertex;  // The root of the shortest-paths tree
+  unsigned int epoch;        // The stamp of the run that filled the arrays
+  unsigned int* negativeCycle;  // [count, vertices...], in edge order
+                                // NULL, if no negative cycle was found
+  unsigned int maxHops;  // Paths with at most maxHops edges; 0: no limit
+  int longestPath;       // 1: the distances are those of the longest paths
+  struct _AtualizacaoIncremental* update;  // State of the incremental updates
+                                           // NULL, before the first one
 };
 
-// Variáveis globais para medir complexidade espacial
-size_t memoria_inicializacao = 0;
-size_t memoria_relaxamento = 0;
-size_t memoria_verificacao = 0;
-size_t memoria_total = 0;
-
-// Funções auxiliares para registrar memória
-static void RegistrarMemoriaAlocada(size_t* contador, size_t bytes) {
-    *contador += bytes;
-    memoria_total += bytes;
-}
-
-static void RegistrarMemoriaLiberada(size_t* contador, size_t bytes) {
-    *contador -= bytes;
-    memoria_total -= bytes;
-}
+// Espaço de trabalho reutilizável
+// Os vetores são alocados uma única vez e servem todas as execuções.
+// Cada execução usa um novo carimbo (epoch): os vértices marcados com um
+// carimbo antigo contam como não visitados, pelo que não é preciso
+// reinicializar os vetores entre execuções.
+struct _GraphBellmanFordAlgWorkspace {
+  GraphBellmanFordAlg resultado;  // O resultado da última execução
+  int* predecessores;             // Sempre alocado; exposto só se pedido
+  GraphCSR* saida;                // Vizinhos de saída
+  int saidaPartilhada;            // 1: a CSR pertence a quem criou o espaço
+  GraphCSR* entrada;              // Vizinhos de entrada, criados a pedido
+  unsigned int numArestas;        // Para detetar alterações ao grafo
+  size_t memoria;                 // Bytes ocupados pelos vetores
+  // Fronteiras da BFS e da relaxação, criadas a pedido
+  GraphFrontier* fronteira;
+  GraphFrontier* proxima;
+  // Deteção de ciclos negativos, só se o grafo tiver pesos negativos
+  int pesosNegativos;
+  unsigned int* passeio;          // Carimbo do último percurso que passou no vértice
+  unsigned int contadorPasseios;
+  unsigned int* ciclo;            // O último ciclo negativo encontrado
+  double* anteriores;             // Distâncias da ronda anterior, criadas a
+                                  // pedido para o modo de saltos limitados
+  GraphEdgeArrays* arestas;       // Lista de arestas, criada a pedido
+  // Ordem topológica, calculada na criação
+  int aciclico;                   // 1: o grafo é um DAG
+  unsigned int* ordemTopologica;  // NULL se o grafo tiver ciclos
+};
 
 // Função para inicializar a estrutura de resultados
-// Esta função configura as distâncias iniciais de todos os vértices como "infinito" (INT_MAX),
-// define que nenhum vértice tem um predecessor no início (-1) e marca todos como não visitados.
+// Começa uma nova execução: um novo carimbo deixa todos os vértices como
+// não visitados, sem percorrer os vetores.
 // Para o vértice inicial, a distância é configurada como 0 e ele é marcado como visitado.
 static void InicializarResultado(GraphBellmanFordAlg* resultado, unsigned int totalVertices, unsigned int inicio) {
-    for (unsigned int i = 0; i < totalVertices; i++) {
-        resultado->distance[i] = INT_MAX; // Considera que todos estão muito longe inicialmente
-        resultado->predecessor[i] = -1;  // Nenhum caminho foi estabelecido ainda
-        resultado->marked[i] = 0;        // Nenhum vértice foi visitado
+    resultado->epoch++;
+    if (resultado->epoch == 0) {
+        // O contador deu a volta: os carimbos antigos têm de ser apagados
+        memset(resultado->marked, 0, totalVertices * sizeof(unsigned int));
+        resultado->epoch = 1;
     }
-    resultado->distance[inicio] = 0; // O ponto de partida está a distância 0 de si mesmo
-    resultado->marked[inicio] = 1;   // Marca o vértice inicial como visitado
 
-    // Registrar memória alocada na inicialização
-    RegistrarMemoriaAlocada(&memoria_inicializacao, totalVertices * sizeof(unsigned int) + 2 * totalVertices * sizeof(int));
+    resultado->startVertex = inicio;
+    resultado->distance[inicio] = 0.0; // O ponto de partida está a distância 0 de si mesmo
+    if (resultado->predecessor != NULL) {
+        resultado->predecessor[inicio] = -1;
+    }
+    resultado->marked[inicio] = resultado->epoch;   // Marca o vértice inicial como visitado
 }
 
-// Função para liberar recursos de memória
-// Esta função é usada para garantir que não haja desperdício de memória alocada temporariamente
-// para os vizinhos e pesos enquanto percorremos o grafo.
-static void LiberarMemoria(unsigned int* adjacentes, double* pesos) {
-    if (adjacentes) {
-        RegistrarMemoriaLiberada(&memoria_relaxamento, sizeof(unsigned int) * adjacentes[0]);
-        free(adjacentes);
-    }
-    if (pesos) {
-        RegistrarMemoriaLiberada(&memoria_relaxamento, sizeof(double) * adjacentes[0]);
-        free(pesos);
+// Cria as duas fronteiras na primeira execução que as usa, e esvazia-as
+static void PrepararFronteiras(GraphBellmanFordAlgWorkspace* espaco, unsigned int totalVertices) {
+    if (espaco->fronteira == NULL) {
+        espaco->fronteira = GraphFrontierCreate(totalVertices);
+        espaco->proxima = GraphFrontierCreate(totalVertices);
+        espaco->memoria += 2 * ((totalVertices + 63) / 64 * sizeof(uint64_t) + (totalVertices + 1) * sizeof(unsigned int));
     }
+    GraphFrontierClear(espaco->fronteira);
+    GraphFrontierClear(espaco->proxima);
+}
+
+// A próxima fronteira passa a atual; a antiga é esvaziada para ser a próxima
+static void TrocarFronteiras(GraphBellmanFordAlgWorkspace* espaco) {
+    GraphFrontier* aux = espaco->fronteira;
+    espaco->fronteira = espaco->proxima;
+    espaco->proxima = aux;
+    GraphFrontierClear(espaco->proxima);
 }
 
 // Função para atualizar distâncias das arestas
 // Esta função percorre todas as arestas do grafo e tenta relaxar (atualizar) as distâncias para os vértices adjacentes.
 // Se encontrar um caminho mais curto para algum vértice, a distância é atualizada e o vértice é marcado como modificado.
-int operation_count = 0;
-clock_t tempo_inicializacao = 0;
-clock_t tempo_relaxamento = 0;
-clock_t tempo_verificacao = 0;
-
-// Instrumentação no loop de relaxamento
-static int AtualizarDistancias(Graph* grafo, GraphBellmanFordAlg* resultado, unsigned int totalVertices) {
-    clock_t start = clock();
-    int houveAtualizacao = 0;
-    for (unsigned int origem = 0; origem < totalVertices; origem++) {
-        if (resultado->distance[origem] == INT_MAX) continue;
-
-        unsigned int* adjacentes = GraphGetAdjacentsTo(grafo, origem);
-        double* pesos = GraphGetDistancesToAdjacents(grafo, origem);
+// Os contadores são os da execução corrente: não há estado global, pelo que
+// várias execuções podem decorrer em simultâneo, em espaços de trabalho distintos.
+// Os predecessores são registados se predecessores != NULL.
+// Se anteriores != NULL, as arestas são relaxadas a partir das distâncias da
+// ronda anterior (INFINITY se o vértice não tinha sido alcançado): após a
+// ronda r, cada distância é exatamente a do melhor caminho com até r arestas.
+// Sem esse vetor, as melhorias da própria ronda propagam-se logo, o que
+// converge em menos rondas mas pode usar caminhos mais longos.
+// Só são relaxadas as arestas que saem dos vértices ativos, cuja distância
+// mudou na ronda anterior: as restantes não podem melhorar nada. Os vértices
+// cuja distância muda nesta ronda são acrescentados a alterados.
+static int AtualizarDistancias(const GraphCSR* adjacencias, GraphBellmanFordAlg* resultado, int* predecessores, const double* anteriores, const GraphFrontier* ativos, GraphFrontier* alterados, GraphBellmanFordAlgStats* estatisticas) {
+    double start = monotonic_time();
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(adjacencias);
+    const unsigned int* vizinhos = GraphCSRGetTargets(adjacencias);
+    const double* pesos = GraphCSRGetWeights(adjacencias);
+    unsigned int epoch = resultado->epoch;
 
-        if (!adjacentes || !pesos) {
-            LiberarMemoria(adjacentes, pesos);
-            continue;
+    int houveAtualizacao = 0;
+    unsigned int cursor = 0;
+    unsigned int origem;
+    while (GraphFrontierNext(ativos, &cursor, &origem)) {
+        double distanciaOrigem;
+        if (anteriores != NULL) {
+            if (anteriores[origem] == INFINITY) continue;
+            distanciaOrigem = anteriores[origem];
+        } else {
+            if (resultado->marked[origem] != epoch) continue;
+            distanciaOrigem = resultado->distance[origem];
         }
 
-        // Registrar memória alocada para adjacentes e pesos
-        RegistrarMemoriaAlocada(&memoria_relaxamento, sizeof(unsigned int) * adjacentes[0]);
-        RegistrarMemoriaAlocada(&memoria_relaxamento, sizeof(double) * adjacentes[0]);
-
-        unsigned int totalAdjacentes = adjacentes[0];
-        for (unsigned int i = 0; i < totalAdjacentes; i++) {
-            operation_count++;  // Conta operações
-            unsigned int destino = adjacentes[i + 1];
-            int peso = (int)pesos[i + 1];
-
-            if (resultado->distance[origem] + peso < resultado->distance[destino]) {
-                resultado->distance[destino] = resultado->distance[origem] + peso;
-                resultado->predecessor[destino] = origem;
-                resultado->marked[destino] = 1;
+        // Conta operações: uma por aresta
+        estatisticas->operations += inicioVizinhos[origem + 1] - inicioVizinhos[origem];
+        for (unsigned int k = inicioVizinhos[origem]; k < inicioVizinhos[origem + 1]; k++) {
+            unsigned int destino = vizinhos[k];
+            double peso = pesos ? pesos[k] : 1.0;
+
+            if (resultado->marked[destino] != epoch ||
+                distanciaOrigem + peso < resultado->distance[destino]) {
+                resultado->distance[destino] = distanciaOrigem + peso;
+                if (predecessores != NULL) {
+                    predecessores[destino] = (int)origem;
+                }
+                resultado->marked[destino] = epoch;
+                GraphFrontierAdd(alterados, destino);
                 houveAtualizacao = 1;
             }
         }
-        LiberarMemoria(adjacentes, pesos);
     }
-    tempo_relaxamento += (clock() - start);
+    estatisticas->rounds++;
+    estatisticas->relaxationTime += monotonic_time() - start;
     return houveAtualizacao;
 }
 
+// Guarda o ciclo que passa pelo vértice dado, no grafo dos predecessores
+// Percorrer os predecessores dá o ciclo ao contrário: é preenchido do fim
+// para o início, ficando os vértices pela ordem das arestas.
+static void ExtrairCiclo(GraphBellmanFordAlgWorkspace* espaco, unsigned int vertice) {
+    const int* predecessores = espaco->predecessores;
+
+    unsigned int tamanho = 0;
+    unsigned int atual = vertice;
+    do {
+        tamanho++;
+        atual = (unsigned int)predecessores[atual];
+    } while (atual != vertice);
+
+    espaco->ciclo[0] = tamanho;
+    atual = vertice;
+    for (unsigned int i = tamanho; i >= 1; i--) {
+        espaco->ciclo[i] = atual;
+        atual = (unsigned int)predecessores[atual];
+    }
+    espaco->resultado.negativeCycle = espaco->ciclo;
+}
+
 // Função para detectar ciclos negativos
-// Esta função verifica se ainda é possível reduzir a distância de algum vértice após todas as iterações esperadas.
-// Se for possível, significa que existe um ciclo com peso negativo no grafo.
-static int DetectarCiclos(Graph* grafo, GraphBellmanFordAlg* resultado, unsigned int totalVertices) {
-    clock_t start = clock();
-    for (unsigned int origem = 0; origem < totalVertices; origem++) {
-        if (resultado->distance[origem] == INT_MAX) continue;
-
-        unsigned int* adjacentes = GraphGetAdjacentsTo(grafo, origem);
-        double* pesos = GraphGetDistancesToAdjacents(grafo, origem);
-
-        if (!adjacentes || !pesos) {
-            LiberarMemoria(adjacentes, pesos);
-            continue;
+// Enquanto as distâncias só diminuem, um ciclo no grafo dos predecessores
+// é sempre um ciclo de peso negativo (Cherkassky e Goldberg, 1999).
+// A verificação custa O(V) e é feita após cada ronda: um ciclo é detetado
+// logo que se forma, sem esperar pelas V-1 rondas.
+// Cada vértice alcançado é percorrido uma única vez: cada percurso segue os
+// predecessores até à raiz ou a um vértice já visto nesta verificação; se
+// esse vértice foi visto no próprio percurso, fecha um ciclo.
+static int ProcurarCicloPredecessores(GraphBellmanFordAlgWorkspace* espaco, GraphBellmanFordAlgStats* estatisticas) {
+    double start = monotonic_time();
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+    unsigned int totalVertices = GraphGetNumVertices(resultado->graph);
+    const int* predecessores = espaco->predecessores;
+    unsigned int* passeio = espaco->passeio;
+    unsigned int epoch = resultado->epoch;
+
+    // Cada verificação usa até V carimbos novos
+    if (espaco->contadorPasseios > UINT_MAX - totalVertices - 1) {
+        memset(passeio, 0, totalVertices * sizeof(unsigned int));
+        espaco->contadorPasseios = 0;
+    }
+    unsigned int primeiro = espaco->contadorPasseios + 1;
+
+    int encontrado = -1;
+    for (unsigned int v = 0; v < totalVertices && encontrado == -1; v++) {
+        if (resultado->marked[v] != epoch || passeio[v] >= primeiro) continue;
+
+        unsigned int carimbo = ++espaco->contadorPasseios;
+        int atual = (int)v;
+        while (atual != -1 && passeio[atual] < primeiro) {
+            estatisticas->operations++;
+            passeio[atual] = carimbo;
+            atual = predecessores[atual];
+        }
+        if (atual != -1 && passeio[atual] == carimbo) {
+            encontrado = atual;
+        }
+    }
+
+    if (encontrado != -1) {
+        ExtrairCiclo(espaco, (unsigned int)encontrado);
+    }
+    estatisticas->cycleCheckTime += monotonic_time() - start;
+    return encontrado != -1;
+}
+
+// Uma ronda sobre a lista de arestas, com o kernel SIMD do processador
+// Os vértices não alcançados têm distância INFINITY, pelo que as arestas
+// que saem deles nunca melhoram nada.
+static int RelaxarArestas(GraphBellmanFordAlgWorkspace* espaco, int* predecessores, const double* anteriores, GraphBellmanFordAlgStats* estatisticas) {
+    double start = monotonic_time();
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+
+    const double* distanciasOrigem = anteriores != NULL ? anteriores : resultado->distance;
+    unsigned int atualizacoes = GraphEdgeArraysRelax(espaco->arestas, distanciasOrigem, resultado->distance, predecessores, resultado->marked, resultado->epoch);
+
+    estatisticas->operations += GraphEdgeArraysGetNumArcs(espaco->arestas);
+    estatisticas->rounds++;
+    estatisticas->relaxationTime += monotonic_time() - start;
+    return atualizacoes > 0;
+}
+
+// Cria, na primeira execução centrada nas arestas, a lista de arestas
+static void PrepararArestas(GraphBellmanFordAlgWorkspace* espaco) {
+    if (espaco->arestas != NULL) return;
+
+    espaco->arestas = GraphEdgeArraysCreate(espaco->saida);
+    espaco->memoria += (GraphEdgeArraysGetNumArcs(espaco->arestas) + 1) * (2 * sizeof(unsigned int) + sizeof(double));
+}
+
+// Guarda as distâncias atuais, antes de uma ronda de saltos limitados
+static void GuardarDistancias(GraphBellmanFordAlgWorkspace* espaco, unsigned int totalVertices) {
+    const GraphBellmanFordAlg* resultado = &espaco->resultado;
+    for (unsigned int v = 0; v < totalVertices; v++) {
+        espaco->anteriores[v] = resultado->marked[v] == resultado->epoch ? resultado->distance[v] : INFINITY;
+    }
+}
+
+// Devolve 0 se for encontrado um ciclo negativo
+// Sem pesos negativos não há ciclos negativos: bastam V-1 rondas.
+// Com pesos negativos, uma ronda V com atualizações implica um ciclo
+// negativo, que a verificação dessa ronda encontra.
+// Com saltos limitados (maxSaltos > 0), são feitas no máximo maxSaltos
+// rondas, sobre as distâncias da ronda anterior; os caminhos são finitos,
+// pelo que não há ciclos a procurar.
+// Centrada nas arestas, cada ronda percorre a lista de arestas em vez das
+// listas de adjacências; as distâncias têm então de começar em INFINITY,
+// o que custa O(V) por execução.
+static int ExecutarRelaxacao(GraphBellmanFordAlgWorkspace* espaco, unsigned int inicio, unsigned int maxSaltos, int centradaNasArestas, GraphBellmanFordAlgStats* estatisticas) {
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+    unsigned int totalVertices = GraphGetNumVertices(resultado->graph);
+
+    double start = monotonic_time();
+    if (centradaNasArestas) {
+        PrepararArestas(espaco);
+        for (unsigned int v = 0; v < totalVertices; v++) {
+            resultado->distance[v] = INFINITY;
         }
+    }
+    InicializarResultado(resultado, totalVertices, inicio);
+    if (!centradaNasArestas) {
+        PrepararFronteiras(espaco, totalVertices);
+        GraphFrontierAdd(espaco->fronteira, inicio);
+    }
+    int verificarCiclos = espaco->pesosNegativos && maxSaltos == 0;
+    // Os predecessores são necessários à deteção de ciclos, mesmo que não
+    // tenham sido pedidos
+    int* predecessores = resultado->predecessor;
+    if (verificarCiclos) {
+        predecessores = espaco->predecessores;
+        predecessores[inicio] = -1;
+    }
+    if (maxSaltos > 0 && espaco->anteriores == NULL) {
+        espaco->anteriores = (double*)malloc((totalVertices + 1) * sizeof(double));
+        if (espaco->anteriores == NULL) abort();
+        espaco->memoria += (totalVertices + 1) * sizeof(double);
+    }
+    estatisticas->initializationTime += monotonic_time() - start;
 
-        // Registrar memória alocada para adjacentes e pesos
-        RegistrarMemoriaAlocada(&memoria_verificacao, sizeof(unsigned int) * adjacentes[0]);
-        RegistrarMemoriaAlocada(&memoria_verificacao, sizeof(double) * adjacentes[0]);
+    unsigned int maxRondas = verificarCiclos ? totalVertices : totalVertices - 1;
+    if (maxSaltos > 0) {
+        maxRondas = maxSaltos;
+    }
+    for (unsigned int iteracao = 1; iteracao <= maxRondas; iteracao++) {
+        const double* anteriores = NULL;
+        if (maxSaltos > 0) {
+            GuardarDistancias(espaco, totalVertices);
+            anteriores = espaco->anteriores;
+        }
+        int houveAtualizacao;
+        if (centradaNasArestas) {
+            houveAtualizacao = RelaxarArestas(espaco, predecessores, anteriores, estatisticas);
+        } else {
+            houveAtualizacao = AtualizarDistancias(espaco->saida, resultado, predecessores, anteriores, espaco->fronteira, espaco->proxima, estatisticas);
+            TrocarFronteiras(espaco);
+        }
+        if (!houveAtualizacao) {
+            break;
+        }
+        if (verificarCiclos && ProcurarCicloPredecessores(espaco, estatisticas)) {
+            return 0;
+        }
+    }
 
-        unsigned int totalAdjacentes = adjacentes[0];
-        for (unsigned int i = 0; i < totalAdjacentes; i++) {
-            operation_count++;  // Conta operações
-            unsigned int destino = adjacentes[i + 1];
-            int peso = (int)pesos[i + 1];
+    return 1;
+}
 
-            if (resultado->distance[origem] + peso < resultado->distance[destino]) {
-                LiberarMemoria(adjacentes, pesos);
-                tempo_verificacao += (clock() - start);
-                return 1;
+// BFS com otimização de direção (top-down / bottom-up)
+// Num grafo sem pesos, a distância é o número de arestas: o nível da BFS.
+// Top-down: os vértices da fronteira visitam os seus vizinhos.
+// Bottom-up: cada vértice ainda não visitado procura um predecessor na
+// fronteira, entre os seus vizinhos de entrada, e pára no primeiro.
+// A passagem para bottom-up compensa quando a fronteira é grande: poucos
+// vértices ficam por visitar e cada um pára cedo.
+// As fronteiras (GraphFrontier) servem os dois sentidos sem conversões:
+// podem ser percorridas em qualquer forma e o teste de pertença usa sempre
+// o mapa de bits.
+
+// Um nível top-down
+static void NivelTopDown(GraphBellmanFordAlgWorkspace* bfs, unsigned int nivel, GraphBellmanFordAlgStats* estatisticas) {
+    GraphBellmanFordAlg* resultado = &bfs->resultado;
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(bfs->saida);
+    const unsigned int* vizinhos = GraphCSRGetTargets(bfs->saida);
+    unsigned int epoch = resultado->epoch;
+
+    unsigned int cursor = 0;
+    unsigned int origem;
+    while (GraphFrontierNext(bfs->fronteira, &cursor, &origem)) {
+        estatisticas->operations += inicioVizinhos[origem + 1] - inicioVizinhos[origem];
+        for (unsigned int k = inicioVizinhos[origem]; k < inicioVizinhos[origem + 1]; k++) {
+            unsigned int destino = vizinhos[k];
+            if (resultado->marked[destino] == epoch) continue;
+            resultado->marked[destino] = epoch;
+            resultado->distance[destino] = nivel;
+            if (resultado->predecessor != NULL) {
+                resultado->predecessor[destino] = (int)origem;
             }
+            GraphFrontierAdd(bfs->proxima, destino);
         }
-        LiberarMemoria(adjacentes, pesos);
     }
-    tempo_verificacao += (clock() - start);
-    return 0;
 }
 
-GraphBellmanFordAlg* GraphBellmanFordAlgExecute(Graph* grafo, unsigned int inicio) {
-    operation_count = 0;  // Reinicia o contador
-    memoria_inicializacao = 0;
-    memoria_relaxamento = 0;
-    memoria_verificacao = 0;
+// Um nível bottom-up
+static void NivelBottomUp(GraphBellmanFordAlgWorkspace* bfs, unsigned int nivel, GraphBellmanFordAlgStats* estatisticas) {
+    GraphBellmanFordAlg* resultado = &bfs->resultado;
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(bfs->entrada);
+    const unsigned int* vizinhos = GraphCSRGetTargets(bfs->entrada);
+    unsigned int totalVertices = GraphCSRGetNumVertices(bfs->entrada);
+    unsigned int epoch = resultado->epoch;
+
+    for (unsigned int destino = 0; destino < totalVertices; destino++) {
+        if (resultado->marked[destino] == epoch) continue;
+        for (unsigned int k = inicioVizinhos[destino]; k < inicioVizinhos[destino + 1]; k++) {
+            unsigned int origem = vizinhos[k];
+            estatisticas->operations++;
+            if (GraphFrontierContains(bfs->fronteira, origem)) {
+                resultado->marked[destino] = epoch;
+                resultado->distance[destino] = nivel;
+                if (resultado->predecessor != NULL) {
+                    resultado->predecessor[destino] = (int)origem;
+                }
+                GraphFrontierAdd(bfs->proxima, destino);
+                break;
+            }
+        }
+    }
+}
 
-    clock_t start = clock();
+// Número de arestas que saem dos vértices da fronteira
+static double ArestasDaFronteira(const GraphBellmanFordAlgWorkspace* bfs) {
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(bfs->saida);
 
-    // Verificações de validade dos parâmetros
-    assert(grafo != NULL);
-    assert(inicio < GraphGetNumVertices(grafo));
-    assert(GraphIsWeighted(grafo) == 0);
+    double arestas = 0.0;
+    unsigned int cursor = 0;
+    unsigned int v;
+    while (GraphFrontierNext(bfs->fronteira, &cursor, &v)) {
+        arestas += inicioVizinhos[v + 1] - inicioVizinhos[v];
+    }
+    return arestas;
+}
 
-    // Aloca a estrutura de resultados
-    GraphBellmanFordAlg* resultado = (GraphBellmanFordAlg*)malloc(sizeof(struct _GraphBellmanFordAlg));
-    RegistrarMemoriaAlocada(&memoria_total, sizeof(struct _GraphBellmanFordAlg));
+// Memória ocupada por uma cópia compacta das listas de adjacências
+static size_t TamanhoCSR(const GraphCSR* adjacencias) {
+    size_t bytes = (GraphCSRGetNumVertices(adjacencias) + 1) * sizeof(unsigned int);
+    bytes += GraphCSRGetNumArcs(adjacencias) * sizeof(unsigned int);
+    if (GraphCSRIsWeighted(adjacencias)) {
+        bytes += GraphCSRGetNumArcs(adjacencias) * sizeof(double);
+    }
+    return bytes;
+}
 
-    unsigned int totalVertices = GraphGetNumVertices(grafo);
+// Cria, na primeira BFS, os vizinhos de entrada
+static void PrepararBFS(GraphBellmanFordAlgWorkspace* espaco) {
+    if (espaco->entrada != NULL) return;
 
-    resultado->graph = grafo;
-    resultado->startVertex = inicio;
-    resultado->marked = (unsigned int*)calloc(totalVertices, sizeof(unsigned int));
-    resultado->distance = (int*)malloc(totalVertices * sizeof(int));
-    resultado->predecessor = (int*)malloc(totalVertices * sizeof(int));
+    // Num grafo não orientado, os vizinhos de entrada são os de saída
+    espaco->entrada = GraphCSRIsDigraph(espaco->saida) ? GraphCSRCreateTranspose(espaco->saida) : espaco->saida;
+    if (espaco->entrada != espaco->saida) {
+        espaco->memoria += TamanhoCSR(espaco->entrada);
+    }
+}
+
+// Com maxNiveis > 0, a BFS pára no nível maxNiveis
+static void ExecutarBFSOtimizada(GraphBellmanFordAlgWorkspace* bfs, unsigned int inicio, double alfa, double beta, unsigned int maxNiveis, GraphBellmanFordAlgStats* estatisticas) {
+    assert(GraphIsWeighted(bfs->resultado.graph) == 0);
+    assert(alfa > 0.0 && beta > 0.0);
+
+    unsigned int totalVertices = GraphGetNumVertices(bfs->resultado.graph);
+
+    double start = monotonic_time();
+    PrepararBFS(bfs);
+    PrepararFronteiras(bfs, totalVertices);
+    InicializarResultado(&bfs->resultado, totalVertices, inicio);
+    GraphFrontierAdd(bfs->fronteira, inicio);
+    estatisticas->initializationTime += monotonic_time() - start;
+    start = monotonic_time();
+
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(bfs->saida);
+
+    // Arestas ainda por explorar: as que saem de vértices não visitados
+    double arestasPorExplorar = (double)GraphCSRGetNumArcs(bfs->saida);
+    arestasPorExplorar -= inicioVizinhos[inicio + 1] - inicioVizinhos[inicio];
+
+    int bottomUp = 0;
+    for (unsigned int nivel = 1; GraphFrontierSize(bfs->fronteira) > 0 && (maxNiveis == 0 || nivel <= maxNiveis); nivel++) {
+        if (!bottomUp) {
+            if (ArestasDaFronteira(bfs) > arestasPorExplorar / alfa) {
+                bottomUp = 1;
+            }
+        } else if (GraphFrontierSize(bfs->fronteira) < totalVertices / beta) {
+            bottomUp = 0;
+        }
+
+        estatisticas->rounds++;
+        if (bottomUp) {
+            NivelBottomUp(bfs, nivel, estatisticas);
+        } else {
+            NivelTopDown(bfs, nivel, estatisticas);
+        }
+        TrocarFronteiras(bfs);
+        arestasPorExplorar -= ArestasDaFronteira(bfs);
+    }
+    estatisticas->relaxationTime += monotonic_time() - start;
+}
 
-    RegistrarMemoriaAlocada(&memoria_total, totalVertices * sizeof(unsigned int) + 2 * totalVertices * sizeof(int));
+// Grafos orientados acíclicos (DAG)
+// Numa ordem topológica, todos os caminhos que chegam a um vértice passam
+// por vértices anteriores: relaxando as arestas de cada vértice pela ordem
+// topológica, cada aresta é relaxada uma única vez e as distâncias ficam
+// finais. O(V + E), com pesos negativos ou não.
+// Sem ciclos, o caminho mais longo também está bem definido: basta trocar
+// o mínimo pelo máximo (caminho crítico).
+
+// Verifica, uma única vez por espaço de trabalho, se o grafo é um DAG
+// Feito na criação, pelo algoritmo de Kahn sobre a CSR: as execuções só
+// leem a CSR, que pode ser partilhada por espaços de várias threads
+static void VerificarAciclico(GraphBellmanFordAlgWorkspace* espaco) {
+    const GraphCSR* adjacencias = espaco->saida;
+    espaco->aciclico = 0;
+    if (!GraphCSRIsDigraph(adjacencias)) return;
+
+    unsigned int totalVertices = GraphCSRGetNumVertices(adjacencias);
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(adjacencias);
+    const unsigned int* vizinhos = GraphCSRGetTargets(adjacencias);
+    unsigned int* grauEntrada = (unsigned int*)calloc(totalVertices + 1, sizeof(unsigned int));
+    unsigned int* ordem = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+    if (grauEntrada == NULL || ordem == NULL) abort();
+
+    for (unsigned int k = 0; k < GraphCSRGetNumArcs(adjacencias); k++) grauEntrada[vizinhos[k]]++;
+    unsigned int fim = 0;
+    for (unsigned int v = 0; v < totalVertices; v++) {
+        if (grauEntrada[v] == 0) ordem[fim++] = v;
+    }
+    // A ordem é também a fila
+    for (unsigned int cabeca = 0; cabeca < fim; cabeca++) {
+        unsigned int v = ordem[cabeca];
+        for (unsigned int k = inicioVizinhos[v]; k < inicioVizinhos[v + 1]; k++) {
+            if (--grauEntrada[vizinhos[k]] == 0) ordem[fim++] = vizinhos[k];
+        }
+    }
+    free(grauEntrada);
 
+    if (fim < totalVertices) {
+        free(ordem);
+        return;
+    }
+    espaco->aciclico = 1;
+    espaco->ordemTopologica = ordem;
+    espaco->memoria += (totalVertices + 1) * sizeof(unsigned int);
+}
+
+static void ExecutarDAG(GraphBellmanFordAlgWorkspace* espaco, unsigned int inicio, int maisLongo, GraphBellmanFordAlgStats* estatisticas) {
+    assert(espaco->aciclico);
+
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+    unsigned int totalVertices = GraphGetNumVertices(resultado->graph);
+
+    double start = monotonic_time();
     InicializarResultado(resultado, totalVertices, inicio);
+    estatisticas->initializationTime += monotonic_time() - start;
+    start = monotonic_time();
+
+    const unsigned int* inicioVizinhos = GraphCSRGetOffsets(espaco->saida);
+    const unsigned int* vizinhos = GraphCSRGetTargets(espaco->saida);
+    const double* pesos = GraphCSRGetWeights(espaco->saida);
+    unsigned int epoch = resultado->epoch;
+
+    // Os vértices antes do inicial não são alcançáveis a partir dele
+    unsigned int i = 0;
+    while (espaco->ordemTopologica[i] != inicio) i++;
+
+    for (; i < totalVertices; i++) {
+        unsigned int origem = espaco->ordemTopologica[i];
+        if (resultado->marked[origem] != epoch) continue;
+
+        estatisticas->operations += inicioVizinhos[origem + 1] - inicioVizinhos[origem];
+        for (unsigned int k = inicioVizinhos[origem]; k < inicioVizinhos[origem + 1]; k++) {
+            unsigned int destino = vizinhos[k];
+            double candidata = resultado->distance[origem] + (pesos ? pesos[k] : 1.0);
+
+            int melhor = resultado->marked[destino] != epoch ||
+                         (maisLongo ? candidata > resultado->distance[destino]
+                                    : candidata < resultado->distance[destino]);
+            if (melhor) {
+                resultado->distance[destino] = candidata;
+                if (resultado->predecessor != NULL) {
+                    resultado->predecessor[destino] = (int)origem;
+                }
+                resultado->marked[destino] = epoch;
+            }
+        }
+    }
+    estatisticas->rounds = 1;
+    estatisticas->relaxationTime += monotonic_time() - start;
+}
 
-    for (unsigned int iteracao = 1; iteracao < totalVertices; iteracao++) {
-        if (!AtualizarDistancias(grafo, resultado, totalVertices)) {
+GraphBellmanFordAlgOptions GraphBellmanFordAlgDefaultOptions(void) {
+    GraphBellmanFordAlgOptions opcoes;
+    opcoes.engine = GRAPH_BF_ENGINE_AUTO;
+    opcoes.alpha = 14.0;
+    opcoes.beta = 24.0;
+    opcoes.trackPredecessors = 1;
+    opcoes.reportNegativeCycle = 0;
+    opcoes.maxHops = 0;
+    opcoes.longestPath = 0;
+    opcoes.stats = NULL;
+    opcoes.verbose = 0;
+    return opcoes;
+}
+
+void GraphBellmanFordAlgStatsPrint(const GraphBellmanFordAlgStats* estatisticas) {
+    assert(estatisticas != NULL);
+
+    printf("Tempo total de execução: %f segundos\n", estatisticas->totalTime);
+    printf("Tempo de Inicialização: %f segundos\n", estatisticas->initializationTime);
+    printf("Tempo de Relaxamento: %f segundos\n", estatisticas->relaxationTime);
+    printf("Tempo de Verificação de Ciclos: %f segundos\n", estatisticas->cycleCheckTime);
+    printf("Memória total utilizada: %zu bytes\n", estatisticas->memoryBytes);
+    printf("Iterações realizadas: %u\n", estatisticas->rounds);
+    printf("Operações realizadas: %lu\n", estatisticas->operations);
+}
+
+// Espaço de trabalho
+
+// Cria o espaço sobre a CSR saida, sem a ordem topológica
+static GraphBellmanFordAlgWorkspace* CriarEspaco(Graph* grafo, GraphCSR* saida, int partilhada) {
+    GraphBellmanFordAlgWorkspace* espaco = (GraphBellmanFordAlgWorkspace*)malloc(sizeof(struct _GraphBellmanFordAlgWorkspace));
+    if (espaco == NULL) abort();
+
+    unsigned int totalVertices = GraphGetNumVertices(grafo);
+
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+    resultado->graph = grafo;
+    resultado->startVertex = 0;
+    resultado->epoch = 0;
+    // Mais uma posição, para evitar malloc(0) num grafo sem vértices
+    resultado->marked = (unsigned int*)calloc(totalVertices + 1, sizeof(unsigned int));
+    resultado->distance = (double*)malloc((totalVertices + 1) * sizeof(double));
+    espaco->predecessores = (int*)malloc((totalVertices + 1) * sizeof(int));
+    if (resultado->marked == NULL || resultado->distance == NULL || espaco->predecessores == NULL) abort();
+    resultado->predecessor = espaco->predecessores;
+    resultado->negativeCycle = NULL;
+    resultado->maxHops = 0;
+    resultado->longestPath = 0;
+    resultado->update = NULL;
+
+    espaco->saida = saida;
+    espaco->saidaPartilhada = partilhada;
+    espaco->memoria = (totalVertices + 1) * (sizeof(unsigned int) + sizeof(double) + sizeof(int));
+    if (!partilhada) espaco->memoria += TamanhoCSR(espaco->saida);
+
+    // Só pode haver ciclos negativos se houver arestas de peso negativo
+    espaco->pesosNegativos = 0;
+    const double* pesos = GraphCSRGetWeights(espaco->saida);
+    for (unsigned int k = 0; pesos != NULL && k < GraphCSRGetNumArcs(espaco->saida); k++) {
+        if (pesos[k] < 0.0) {
+            espaco->pesosNegativos = 1;
             break;
         }
     }
+    espaco->passeio = NULL;
+    espaco->contadorPasseios = 0;
+    espaco->ciclo = NULL;
+    espaco->anteriores = NULL;
+    espaco->arestas = NULL;
+    espaco->ordemTopologica = NULL;
+    if (espaco->pesosNegativos) {
+        espaco->passeio = (unsigned int*)calloc(totalVertices + 1, sizeof(unsigned int));
+        espaco->ciclo = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+        if (espaco->passeio == NULL || espaco->ciclo == NULL) abort();
+        espaco->memoria += 2 * (totalVertices + 1) * sizeof(unsigned int);
+    }
+    espaco->entrada = NULL;
+    espaco->numArestas = GraphGetNumEdges(grafo);
+
+    espaco->fronteira = NULL;
+    espaco->proxima = NULL;
+
+    return espaco;
+}
+
+GraphBellmanFordAlgWorkspace* GraphBellmanFordAlgWorkspaceCreate(Graph* grafo) {
+    assert(grafo != NULL);
+
+    GraphBellmanFordAlgWorkspace* espaco = CriarEspaco(grafo, GraphCSRCreate(grafo), 0);
+    VerificarAciclico(espaco);
+    return espaco;
+}
+
+GraphBellmanFordAlgWorkspace* GraphBellmanFordAlgWorkspaceCreateShared(Graph* grafo, const GraphCSR* adjacencias) {
+    assert(grafo != NULL);
+    assert(adjacencias != NULL);
+    assert(GraphCSRGetNumVertices(adjacencias) == GraphGetNumVertices(grafo));
+
+    // A CSR é só lida: as execuções nunca a alteram
+    GraphBellmanFordAlgWorkspace* espaco = CriarEspaco(grafo, (GraphCSR*)adjacencias, 1);
+    VerificarAciclico(espaco);
+    return espaco;
+}
+
+void GraphBellmanFordAlgWorkspaceDestroy(GraphBellmanFordAlgWorkspace** p) {
+    assert(*p != NULL);
+
+    GraphBellmanFordAlgWorkspace* aux = *p;
+
+    free(aux->resultado.marked);
+    free(aux->resultado.distance);
+    free(aux->predecessores);
+
+    if (aux->entrada != NULL && aux->entrada != aux->saida) {
+        GraphCSRDestroy(&aux->entrada);
+    }
+    if (!aux->saidaPartilhada) GraphCSRDestroy(&aux->saida);
+
+    if (aux->fronteira != NULL) {
+        GraphFrontierDestroy(&aux->fronteira);
+        GraphFrontierDestroy(&aux->proxima);
+    }
 
-    if (DetectarCiclos(grafo, resultado, totalVertices)) {
-        GraphBellmanFordAlgDestroy(&resultado);
-        return NULL;
+    free(aux->passeio);
+    free(aux->ciclo);
+    free(aux->anteriores);
+    if (aux->arestas != NULL) {
+        GraphEdgeArraysDestroy(&aux->arestas);
     }
+    free(aux->ordemTopologica);
 
-    clock_t end = clock();
-    printf("Tempo total de execução: %f segundos\n", ((double)(end - start)) / CLOCKS_PER_SEC);
-    printf("Tempo de Inicialização: %f segundos\n", ((double)tempo_inicializacao) / CLOCKS_PER_SEC);
-    printf("Tempo de Relaxamento: %f segundos\n", ((double)tempo_relaxamento) / CLOCKS_PER_SEC);
-    printf("Tempo de Verificação de Ciclos: %f segundos\n", ((double)tempo_verificacao) / CLOCKS_PER_SEC);
-    printf("Memória total utilizada: %zu bytes\n", memoria_total);
-    printf("Memória Inicialização: %zu bytes\n", memoria_inicializacao);
-    printf("Memória Relaxamento: %zu bytes\n", memoria_relaxamento);
-    printf("Memória Verificação de Ciclos: %zu bytes\n", memoria_verificacao);
-    printf("Operações realizadas: %d\n", operation_count);
+    free(*p);
+    *p = NULL;
+}
+
+const GraphBellmanFordAlg* GraphBellmanFordAlgExecuteInWorkspace(GraphBellmanFordAlgWorkspace* espaco, unsigned int inicio, const GraphBellmanFordAlgOptions* opcoes) {
+    assert(espaco != NULL);
+    assert(opcoes != NULL);
+    assert(inicio < GraphGetNumVertices(espaco->resultado.graph));
+    // O grafo não pode ter mudado desde a criação do espaço de trabalho
+    assert(espaco->numArestas == GraphGetNumEdges(espaco->resultado.graph));
+
+    GraphBellmanFordAlg* resultado = &espaco->resultado;
+    // Com saltos limitados num grafo com pesos, o predecessor de um vértice
+    // pode ter sido melhorado depois, por um caminho com mais arestas: os
+    // predecessores não formam caminhos válidos e não são registados
+    int predecessoresValidos = opcoes->maxHops == 0 || !GraphIsWeighted(resultado->graph);
+    resultado->predecessor = (opcoes->trackPredecessors && predecessoresValidos) ? espaco->predecessores : NULL;
+    resultado->negativeCycle = NULL;
+    resultado->maxHops = opcoes->maxHops;
+
+    // As estatísticas são sempre recolhidas, numa variável local se o
+    // chamador não as pediu
+    GraphBellmanFordAlgStats local;
+    GraphBellmanFordAlgStats* estatisticas = opcoes->stats != NULL ? opcoes->stats : &local;
+    memset(estatisticas, 0, sizeof(GraphBellmanFordAlgStats));
+    double start = monotonic_time();
+
+    // Os caminhos mais longos só são calculados num DAG; por omissão, um
+    // grafo orientado é verificado e, se for um DAG, não há rondas
+    GraphBellmanFordAlgEngine motor = opcoes->engine;
+    if (opcoes->longestPath ||
+        (motor == GRAPH_BF_ENGINE_AUTO && opcoes->maxHops == 0 && espaco->aciclico)) {
+        motor = GRAPH_BF_ENGINE_DAG;
+    }
+    assert(!opcoes->longestPath || opcoes->engine == GRAPH_BF_ENGINE_AUTO || opcoes->engine == GRAPH_BF_ENGINE_DAG);
+    assert(motor != GRAPH_BF_ENGINE_DAG || opcoes->maxHops == 0);
+    resultado->longestPath = opcoes->longestPath;
+
+    int semCiclos = 1;
+    if (motor == GRAPH_BF_ENGINE_DAG) {
+        ExecutarDAG(espaco, inicio, opcoes->longestPath, estatisticas);
+    } else if (motor == GRAPH_BF_ENGINE_DIRECTION_OPTIMIZING_BFS) {
+        ExecutarBFSOtimizada(espaco, inicio, opcoes->alpha, opcoes->beta, opcoes->maxHops, estatisticas);
+    } else {
+        // Por omissão, os grafos com pesos usam a lista de arestas
+        int centradaNasArestas = motor == GRAPH_BF_ENGINE_EDGE_CENTRIC ||
+                                 (motor == GRAPH_BF_ENGINE_AUTO && GraphIsWeighted(resultado->graph));
+        semCiclos = ExecutarRelaxacao(espaco, inicio, opcoes->maxHops, centradaNasArestas, estatisticas);
+    }
+
+    estatisticas->totalTime = monotonic_time() - start;
+    estatisticas->memoryBytes = espaco->memoria;
+    if (opcoes->verbose) {
+        GraphBellmanFordAlgStatsPrint(estatisticas);
+    }
+
+    return (semCiclos || opcoes->reportNegativeCycle) ? resultado : NULL;
+}
+
+// Execuções isoladas: o resultado fica com os vetores do espaço de trabalho
+
+GraphBellmanFordAlg* GraphBellmanFordAlgExecute(Graph* grafo, unsigned int inicio) {
+    GraphBellmanFordAlgOptions opcoes = GraphBellmanFordAlgDefaultOptions();
+    return GraphBellmanFordAlgExecuteWithOptions(grafo, inicio, &opcoes);
+}
+
+GraphBellmanFordAlg* GraphBellmanFordAlgExecuteWithOptions(Graph* grafo, unsigned int inicio, const GraphBellmanFordAlgOptions* opcoes) {
+    // Verificações de validade dos parâmetros
+    assert(grafo != NULL);
+    assert(inicio < GraphGetNumVertices(grafo));
+    assert(opcoes != NULL);
+
+    GraphBellmanFordAlgWorkspace* espaco = GraphBellmanFordAlgWorkspaceCreate(grafo);
+
+    GraphBellmanFordAlg* resultado = NULL;
+    if (GraphBellmanFordAlgExecuteInWorkspace(espaco, inicio, opcoes) != NULL) {
+        // Aloca a estrutura de resultados e transfere-lhe os vetores
+        resultado = (GraphBellmanFordAlg*)malloc(sizeof(struct _GraphBellmanFordAlg));
+        if (resultado == NULL) abort();
+        *resultado = espaco->resultado;
+        if (resultado->predecessor == NULL) {
+            free(espaco->predecessores);
+        }
+        if (resultado->negativeCycle != NULL) {
+            espaco->ciclo = NULL;
+        }
+        espaco->resultado.marked = NULL;
+        espaco->resultado.distance = NULL;
+        espaco->predecessores = NULL;
+    }
+
+    GraphBellmanFordAlgWorkspaceDestroy(&espaco);
 
     return resultado; // Retorna o resultado final com as distâncias calculadas
 }
 
+// Definida com a atualização incremental
+static void DestruirAtualizacao(struct _AtualizacaoIncremental* a);
+
 void GraphBellmanFordAlgDestroy(GraphBellmanFordAlg** p) {
   assert(*p != NULL);
 
@@ -229,36 +811,263 @@ void GraphBellmanFordAlgDestroy(GraphBellmanFordAlg** p) {
   free(aux->marked);
   free(aux->predecessor);
   free(aux->distance);
+  free(aux->negativeCycle);
+  if (aux->update != NULL) DestruirAtualizacao(aux->update);
 
   free(*p);
   *p = NULL;
 }
 
+// Atualização incremental, após a inserção de arestas
+// Só as distâncias dos vértices afetados podem diminuir: as novas arestas
+// são relaxadas e as melhorias propagam-se a partir dos seus destinos,
+// numa fila FIFO (correção de etiquetas, como em Ramalingam e Reps).
+// Os restantes vértices não são visitados.
+
+// Estado das atualizações, criado na primeira e reutilizado pelas seguintes
+// Cada atualização usa um novo carimbo: os vetores só são válidos para os
+// vértices tocados com o carimbo atual, pelo que nada é limpo em O(V).
+// As adjacências de um vértice afetado são obtidas do grafo na sua primeira
+// visita; um vértice que volta à fila reutiliza-as, sem novas alocações.
+// No fim, só são libertadas as dos vértices visitados.
+typedef struct _AtualizacaoIncremental {
+    unsigned int carimbo;        // A atualização em curso
+    unsigned int* tocado;        // tocado[v] == carimbo: v entrou na fila
+    unsigned int* entradas;      // Quantas vezes v entrou na fila, se tocado
+    unsigned char* naFila;       // 1: v está na fila, se tocado
+    // Fila circular dos vértices afetados
+    unsigned int* fila;
+    unsigned int inicio;
+    unsigned int tamanho;
+    unsigned int capacidade;
+    // Adjacências obtidas nesta atualização; NULL fora de uma atualização
+    unsigned int** adjacentes;
+    double** pesos;              // NULL se o grafo não tiver pesos
+    unsigned int* obtidos;       // Os vértices cujas adjacências foram obtidas
+    unsigned int numObtidos;
+} AtualizacaoIncremental;
+
+static AtualizacaoIncremental* CriarAtualizacao(Graph* grafo) {
+    AtualizacaoIncremental* a = (AtualizacaoIncremental*)malloc(sizeof(AtualizacaoIncremental));
+    if (a == NULL) abort();
+
+    unsigned int totalVertices = GraphGetNumVertices(grafo);
+    a->carimbo = 0;
+    a->capacidade = totalVertices;
+    a->tocado = (unsigned int*)calloc(totalVertices + 1, sizeof(unsigned int));
+    a->entradas = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+    a->naFila = (unsigned char*)malloc((totalVertices + 1) * sizeof(unsigned char));
+    a->fila = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+    a->adjacentes = (unsigned int**)calloc(totalVertices + 1, sizeof(unsigned int*));
+    a->pesos = GraphIsWeighted(grafo) ? (double**)calloc(totalVertices + 1, sizeof(double*)) : NULL;
+    a->obtidos = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+    if (a->tocado == NULL || a->entradas == NULL || a->naFila == NULL || a->fila == NULL ||
+        a->adjacentes == NULL || (GraphIsWeighted(grafo) && a->pesos == NULL) || a->obtidos == NULL) {
+        abort();
+    }
+    return a;
+}
+
+static void DestruirAtualizacao(AtualizacaoIncremental* a) {
+    free(a->tocado);
+    free(a->entradas);
+    free(a->naFila);
+    free(a->fila);
+    free(a->adjacentes);
+    free(a->pesos);
+    free(a->obtidos);
+    free(a);
+}
+
+static void ObterAdjacencias(AtualizacaoIncremental* a, Graph* grafo, unsigned int v) {
+    if (a->adjacentes[v] != NULL) return;
+    a->adjacentes[v] = GraphGetAdjacentsTo(grafo, v);
+    if (a->pesos != NULL) {
+        a->pesos[v] = GraphGetDistancesToAdjacents(grafo, v);
+    }
+    a->obtidos[a->numObtidos++] = v;
+}
+
+// Peso da aresta (origem, destino), que tem de existir no grafo
+static double PesoDaAresta(AtualizacaoIncremental* a, Graph* grafo, unsigned int origem, unsigned int destino) {
+    if (a->pesos == NULL) return 1.0;
+
+    ObterAdjacencias(a, grafo, origem);
+    const unsigned int* adjacentes = a->adjacentes[origem];
+    for (unsigned int i = 1; i <= adjacentes[0]; i++) {
+        if (adjacentes[i] == destino) {
+            return a->pesos[origem][i];
+        }
+    }
+
+    assert(0);
+    return 0.0;
+}
+
+// Relaxa a aresta (origem, destino); devolve 0 se o destino entrou na fila
+// mais de V vezes, o que só acontece com um ciclo negativo
+static int RelaxarAfetado(GraphBellmanFordAlg* resultado, unsigned int origem, unsigned int destino, double peso) {
+    unsigned int epoch = resultado->epoch;
+    if (resultado->marked[origem] != epoch) return 1;
+
+    double novaDistancia = resultado->distance[origem] + peso;
+    if (resultado->marked[destino] == epoch && novaDistancia >= resultado->distance[destino]) {
+        return 1;
+    }
+
+    resultado->marked[destino] = epoch;
+    resultado->distance[destino] = novaDistancia;
+    if (resultado->predecessor != NULL) {
+        resultado->predecessor[destino] = (int)origem;
+    }
+
+    AtualizacaoIncremental* a = resultado->update;
+    if (a->tocado[destino] != a->carimbo) {
+        a->tocado[destino] = a->carimbo;
+        a->entradas[destino] = 0;
+        a->naFila[destino] = 0;
+    }
+    if (!a->naFila[destino]) {
+        if (++a->entradas[destino] > a->capacidade) return 0;
+        a->naFila[destino] = 1;
+        a->fila[(a->inicio + a->tamanho) % a->capacidade] = destino;
+        a->tamanho++;
+    }
+    return 1;
+}
+
+int GraphBellmanFordAlgUpdateAfterInsertions(GraphBellmanFordAlg* p, const unsigned int* tails, const unsigned int* heads, unsigned int numEdges) {
+    assert(p != NULL);
+    assert(p->negativeCycle == NULL);
+    assert(p->maxHops == 0);
+    assert(p->longestPath == 0);
+    assert(numEdges == 0 || (tails != NULL && heads != NULL));
+
+    Graph* grafo = p->graph;
+    unsigned int totalVertices = GraphGetNumVertices(grafo);
+
+    if (p->update == NULL) {
+        p->update = CriarAtualizacao(grafo);
+    }
+    AtualizacaoIncremental* a = p->update;
+    a->carimbo++;
+    if (a->carimbo == 0) {
+        // O carimbo deu a volta: limpa os vetores, uma vez em 2^32
+        memset(a->tocado, 0, (totalVertices + 1) * sizeof(unsigned int));
+        a->carimbo = 1;
+    }
+    a->inicio = 0;
+    a->tamanho = 0;
+    a->numObtidos = 0;
+
+    int semCiclos = 1;
+    for (unsigned int i = 0; i < numEdges && semCiclos; i++) {
+        assert(tails[i] < totalVertices && heads[i] < totalVertices);
+        double peso = PesoDaAresta(a, grafo, tails[i], heads[i]);
+        semCiclos = RelaxarAfetado(p, tails[i], heads[i], peso);
+        // Num grafo não orientado, a aresta pode ser usada nos dois sentidos
+        if (semCiclos && !GraphIsDigraph(grafo)) {
+            semCiclos = RelaxarAfetado(p, heads[i], tails[i], peso);
+        }
+    }
+
+    while (a->tamanho > 0 && semCiclos) {
+        unsigned int origem = a->fila[a->inicio];
+        a->inicio = (a->inicio + 1) % a->capacidade;
+        a->tamanho--;
+        a->naFila[origem] = 0;
+
+        ObterAdjacencias(a, grafo, origem);
+        const unsigned int* adjacentes = a->adjacentes[origem];
+        const double* pesos = a->pesos != NULL ? a->pesos[origem] : NULL;
+        for (unsigned int k = 1; k <= adjacentes[0] && semCiclos; k++) {
+            semCiclos = RelaxarAfetado(p, origem, adjacentes[k], pesos ? pesos[k] : 1.0);
+        }
+    }
+
+    // Só os vértices visitados têm adjacências a libertar
+    for (unsigned int i = 0; i < a->numObtidos; i++) {
+        unsigned int v = a->obtidos[i];
+        free(a->adjacentes[v]);
+        a->adjacentes[v] = NULL;
+        if (a->pesos != NULL) {
+            free(a->pesos[v]);
+            a->pesos[v] = NULL;
+        }
+    }
+
+    return semCiclos;
+}
+
 // Getting the paths information
 
 int GraphBellmanFordAlgReached(const GraphBellmanFordAlg* p, unsigned int v) {
   assert(p != NULL);
   assert(v < GraphGetNumVertices(p->graph));
 
-  return p->marked[v];
+  return p->marked[v] == p->epoch;
 }
 
 int GraphBellmanFordAlgDistance(const GraphBellmanFordAlg* p, unsigned int v) {
   assert(p != NULL);
   assert(v < GraphGetNumVertices(p->graph));
+  assert(GraphIsWeighted(p->graph) == 0);
+
+  if (p->marked[v] != p->epoch) {
+    return -1;
+  }
+  return (int)p->distance[v];
+}
+
+double GraphBellmanFordAlgWeightedDistance(const GraphBellmanFordAlg* p,
+                                           unsigned int v) {
+  assert(p != NULL);
+  assert(v < GraphGetNumVertices(p->graph));
 
+  if (p->marked[v] != p->epoch) {
+    return INFINITY;
+  }
   return p->distance[v];
 }
 
+int GraphBellmanFordAlgHasNegativeCycle(const GraphBellmanFordAlg* p) {
+  assert(p != NULL);
+
+  return p->negativeCycle != NULL;
+}
+
+unsigned int* GraphBellmanFordAlgGetNegativeCycle(const GraphBellmanFordAlg* p) {
+  assert(p != NULL);
+
+  unsigned int count = p->negativeCycle != NULL ? p->negativeCycle[0] : 0;
+  unsigned int* cycle = (unsigned int*)malloc((count + 1) * sizeof(unsigned int));
+  if (cycle == NULL) abort();
+
+  cycle[0] = count;
+  for (unsigned int i = 1; i <= count; i++) {
+    cycle[i] = p->negativeCycle[i];
+  }
+  return cycle;
+}
+
 Stack* GraphBellmanFordAlgPathTo(const GraphBellmanFordAlg* p, unsigned int v) {
   assert(p != NULL);
   assert(v < GraphGetNumVertices(p->graph));
+  assert(p->predecessor != NULL);
+  // With a negative cycle, the predecessors may not lead to the start vertex
+  assert(p->negativeCycle == NULL);
 
-  Stack* s = StackCreate(GraphGetNumVertices(p->graph));
+  if (p->marked[v] != p->epoch) {
+    return StackCreate(1);
+  }
 
-  if (p->marked[v] == 0) {
-    return s;
+  // The stack is sized to the path, not to the number of vertices
+  int length = 1;
+  for (unsigned int current = v; current != p->startVertex;
+       current = p->predecessor[current]) {
+    length++;
   }
+  Stack* s = StackCreate(length);
 
   // Store the path
   for (unsigned int current = v; current != p->startVertex;
@@ -271,24 +1080,159 @@ Stack* GraphBellmanFordAlgPathTo(const GraphBellmanFordAlg* p, unsigned int v) {
   return s;
 }
 
+// Caminhos para vários destinos, num único vetor
+// Cada caminho é o caminho do predecessor do destino, seguido do destino:
+// um vértice já escrito num caminho anterior tem o seu caminho completo
+// logo antes dele, que é copiado em bloco em vez de voltar a subir a árvore.
+// Assim, cada vértice da árvore é visitado uma única vez; o resto do custo
+// é o da cópia dos caminhos.
+
+struct _GraphBellmanFordAlgPaths {
+  unsigned int numPaths;
+  size_t* offsets;         // Path i is vertices[offsets[i] .. offsets[i+1]-1]
+  unsigned int* vertices;  // Each path goes from the start vertex to its target
+};
+
+GraphBellmanFordAlgPaths* GraphBellmanFordAlgPathsTo(const GraphBellmanFordAlg* p, const unsigned int* targets, unsigned int numTargets) {
+    assert(p != NULL);
+    assert(p->predecessor != NULL);
+    assert(p->negativeCycle == NULL);
+
+    unsigned int totalVertices = GraphGetNumVertices(p->graph);
+    if (targets == NULL) {
+        numTargets = totalVertices;
+    }
+
+    GraphBellmanFordAlgPaths* caminhos = (GraphBellmanFordAlgPaths*)malloc(sizeof(struct _GraphBellmanFordAlgPaths));
+    if (caminhos == NULL) abort();
+    caminhos->numPaths = numTargets;
+    caminhos->offsets = (size_t*)malloc((numTargets + 1) * sizeof(size_t));
+
+    // profundidade[v]: número de vértices do caminho até v; 0 se ainda
+    // desconhecido. posicao[v]: onde v foi escrito pela primeira vez.
+    unsigned int* profundidade = (unsigned int*)calloc(totalVertices + 1, sizeof(unsigned int));
+    size_t* posicao = (size_t*)malloc((totalVertices + 1) * sizeof(size_t));
+    unsigned int* pilha = (unsigned int*)malloc((totalVertices + 1) * sizeof(unsigned int));
+    if (caminhos->offsets == NULL || profundidade == NULL || posicao == NULL || pilha == NULL) abort();
+
+    // 1ª passagem: comprimento de cada caminho
+    profundidade[p->startVertex] = 1;
+    caminhos->offsets[0] = 0;
+    for (unsigned int i = 0; i < numTargets; i++) {
+        unsigned int destino = targets != NULL ? targets[i] : i;
+        assert(destino < totalVertices);
+
+        size_t comprimento = 0;
+        if (p->marked[destino] == p->epoch) {
+            unsigned int topo = 0;
+            unsigned int atual = destino;
+            while (profundidade[atual] == 0) {
+                pilha[topo++] = atual;
+                atual = (unsigned int)p->predecessor[atual];
+            }
+            while (topo > 0) {
+                unsigned int v = pilha[--topo];
+                profundidade[v] = profundidade[atual] + 1;
+                atual = v;
+            }
+            comprimento = profundidade[destino];
+        }
+        caminhos->offsets[i + 1] = caminhos->offsets[i] + comprimento;
+    }
+
+    // 2ª passagem: escrita dos caminhos
+    caminhos->vertices = (unsigned int*)malloc((caminhos->offsets[numTargets] + 1) * sizeof(unsigned int));
+    if (caminhos->vertices == NULL) abort();
+    for (unsigned int v = 0; v < totalVertices; v++) {
+        posicao[v] = SIZE_MAX;
+    }
+
+    for (unsigned int i = 0; i < numTargets; i++) {
+        if (caminhos->offsets[i + 1] == caminhos->offsets[i]) continue;
+        unsigned int destino = targets != NULL ? targets[i] : i;
+        size_t escrita = caminhos->offsets[i];
+
+        // Sobe a árvore até um vértice já escrito, ou até à raiz
+        unsigned int topo = 0;
+        int atual = (int)destino;
+        while (atual != -1 && posicao[atual] == SIZE_MAX) {
+            pilha[topo++] = (unsigned int)atual;
+            atual = p->predecessor[atual];
+        }
+        if (atual != -1) {
+            // O caminho até atual termina na sua posição
+            size_t comprimento = profundidade[atual];
+            memcpy(&caminhos->vertices[escrita], &caminhos->vertices[posicao[atual] + 1 - comprimento], comprimento * sizeof(unsigned int));
+            escrita += comprimento;
+        }
+        while (topo > 0) {
+            unsigned int v = pilha[--topo];
+            posicao[v] = escrita;
+            caminhos->vertices[escrita++] = v;
+        }
+        assert(escrita == caminhos->offsets[i + 1]);
+    }
+
+    free(profundidade);
+    free(posicao);
+    free(pilha);
+
+    return caminhos;
+}
+
+void GraphBellmanFordAlgPathsDestroy(GraphBellmanFordAlgPaths** p) {
+  assert(*p != NULL);
+
+  GraphBellmanFordAlgPaths* aux = *p;
+
+  free(aux->offsets);
+  free(aux->vertices);
+
+  free(*p);
+  *p = NULL;
+}
+
+unsigned int GraphBellmanFordAlgPathsGetNumPaths(const GraphBellmanFordAlgPaths* paths) {
+  assert(paths != NULL);
+
+  return paths->numPaths;
+}
+
+unsigned int GraphBellmanFordAlgPathsGetLength(const GraphBellmanFordAlgPaths* paths, unsigned int i) {
+  assert(paths != NULL);
+  assert(i < paths->numPaths);
+
+  return (unsigned int)(paths->offsets[i + 1] - paths->offsets[i]);
+}
+
+const unsigned int* GraphBellmanFordAlgPathsGetPath(const GraphBellmanFordAlgPaths* paths, unsigned int i) {
+  assert(paths != NULL);
+  assert(i < paths->numPaths);
+
+  return &paths->vertices[paths->offsets[i]];
+}
+
 // DISPLAYING on the console
 
 void GraphBellmanFordAlgShowPath(const GraphBellmanFordAlg* p, unsigned int v) {
   assert(p != NULL);
   assert(v < GraphGetNumVertices(p->graph));
 
-  Stack* s = GraphBellmanFordAlgPathTo(p, v);
+  // No Stack: the path may be longer than a Stack can hold
+  GraphBellmanFordAlgPaths* paths = GraphBellmanFordAlgPathsTo(p, &v, 1);
 
-  while (StackIsEmpty(s) == 0) {
-    printf("%d ", StackPop(s));
+  const unsigned int* path = GraphBellmanFordAlgPathsGetPath(paths, 0);
+  for (unsigned int i = 0; i < GraphBellmanFordAlgPathsGetLength(paths, 0); i++) {
+    printf("%u ", path[i]);
   }
 
-  StackDestroy(&s);
+  GraphBellmanFordAlgPathsDestroy(&paths);
 }
 
 // Display the Shortest-Paths Tree in DOT format
 void GraphBellmanFordAlgDisplayDOT(const GraphBellmanFordAlg* p) {
   assert(p != NULL);
+  assert(p->predecessor != NULL);
 
   Graph* original_graph = p->graph;
   unsigned int num_vertices = GraphGetNumVertices(original_graph);
@@ -298,6 +1242,7 @@ void GraphBellmanFordAlgDisplayDOT(const GraphBellmanFordAlg* p) {
 
   // Use o array de predecessores para adicionar as arestas da árvore
   for (unsigned int w = 0; w < num_vertices; w++) {
+    if (p->marked[w] != p->epoch) continue;  // Vértice não alcançado
     int v = p->predecessor[w];
     if (v != -1 && v != (int)w) {  // Evitar self-loops
       GraphAddEdge(paths_tree, (unsigned int)v, w);
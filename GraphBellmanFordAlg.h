@@ -9,26 +9,194 @@
 #ifndef _GRAPH_BELLMAN_FORD_ALG_
 #define _GRAPH_BELLMAN_FORD_ALG_
 
+#include <stddef.h>
+
 #include "Graph.h"
+#include "GraphCSR.h"
 #include "IntegersStack.h"
 
 typedef struct _GraphBellmanFordAlg GraphBellmanFordAlg;
 
+// Statistics of one run
+// Filled only if requested through the options: each run has its own
+// counters, so that runs in different workspaces can proceed concurrently
+
+typedef struct {
+  double totalTime;           // Seconds, measured with a monotonic clock
+  double initializationTime;
+  double relaxationTime;      // Relaxation rounds or BFS levels
+  double cycleCheckTime;      // Negative-cycle check
+  size_t memoryBytes;         // Memory held by the arrays used in the run
+  unsigned int rounds;        // Relaxation rounds or BFS levels
+  unsigned long operations;   // Edges examined
+} GraphBellmanFordAlgStats;
+
+// The algorithm used to build the shortest-paths tree
+// All engines fill the same result: the queries below work on any of them
+
+typedef enum {
+  GRAPH_BF_ENGINE_AUTO,        // Chosen from the graph properties
+  GRAPH_BF_ENGINE_RELAXATION,  // Rounds of relaxation of every edge
+  GRAPH_BF_ENGINE_DIRECTION_OPTIMIZING_BFS,  // Top-down / bottom-up BFS
+                                             // (unweighted graphs)
+  GRAPH_BF_ENGINE_EDGE_CENTRIC,  // Rounds over a flat edge list, with SIMD
+                                 // kernels (see GraphEdgeArrays)
+                                 // AUTO uses it for weighted graphs
+  GRAPH_BF_ENGINE_DAG  // Acyclic digraphs: each edge is relaxed once, in
+                       // topological order, in O(V + E)
+                       // AUTO uses it for every acyclic digraph
+} GraphBellmanFordAlgEngine;
+
+typedef struct {
+  GraphBellmanFordAlgEngine engine;
+  // Direction-optimizing BFS heuristics (Beamer et al., SC 2012)
+  // Go bottom-up when: frontier edges > unexplored edges / alpha
+  // Go back top-down when: frontier vertices < number of vertices / beta
+  double alpha;
+  double beta;
+  // 0: only distances are computed; PathTo, ShowPath and DisplayDOT are
+  // not available on the result
+  int trackPredecessors;
+  // 1: if a negative cycle is found, the result is returned anyway, holding
+  // the cycle (its distances are then meaningless); 0: NULL is returned
+  // Negative cycles are only possible, and only searched for, if some edge
+  // has a negative weight: the relaxation engine then checks the tree of
+  // predecessors after each round, and stops as soon as a cycle shows up
+  int reportNegativeCycle;
+  // > 0: shortest paths with at most maxHops edges; each relaxation round
+  // starts from the distances of the previous one, and the run stops after
+  // maxHops rounds (BFS: levels)
+  // Weighted graphs: the predecessors are not tracked in this mode
+  unsigned int maxHops;
+  // 1: longest paths instead of shortest paths (e.g., the critical path of
+  // a dependency graph); acyclic digraphs only, with the DAG engine
+  int longestPath;
+  GraphBellmanFordAlgStats* stats;  // NULL: statistics are not returned
+  int verbose;                      // 1: print the statistics of the run
+} GraphBellmanFordAlgOptions;
+
+GraphBellmanFordAlgOptions GraphBellmanFordAlgDefaultOptions(void);
+
+// Uses the default options
 GraphBellmanFordAlg* GraphBellmanFordAlgExecute(Graph* g,
                                                 unsigned int startVertex);
 
+GraphBellmanFordAlg* GraphBellmanFordAlgExecuteWithOptions(
+    Graph* g, unsigned int startVertex,
+    const GraphBellmanFordAlgOptions* options);
+
 void GraphBellmanFordAlgDestroy(GraphBellmanFordAlg** p);
 
+//
+// Repairs a result after new edges were added to its graph: edge i goes
+// from tails[i] to heads[i] (either way, for an undirected graph)
+// Only the vertices whose distance decreases are visited, instead of
+// running the whole algorithm again
+// The first update allocates O(V) state, kept in the result: later updates
+// cost only the affected vertices and their arcs
+// Not available for results limited to maxHops edges, nor for longest paths
+// Returns 0 if the new edges close a negative cycle reachable from the
+// start vertex; the result is then no longer valid and must be destroyed
+//
+int GraphBellmanFordAlgUpdateAfterInsertions(GraphBellmanFordAlg* p,
+                                             const unsigned int* tails,
+                                             const unsigned int* heads,
+                                             unsigned int numEdges);
+
+// Reusable workspace
+// Owns the result arrays and a CSR snapshot of the graph, so that many runs
+// on the same graph (e.g., one per source vertex) allocate nothing.
+// Starting a run costs O(1): the arrays are not reinitialized.
+// The graph must not change while the workspace is in use.
+// Creating a workspace reads the graph, which is not thread-safe; after
+// that, runs read the snapshot and, of the graph, only its scalar fields
+// (numbers of vertices and edges, kind), which do not change while the
+// graph is not modified: distinct workspaces of the same graph can be used
+// by distinct threads at the same time.
+
+typedef struct _GraphBellmanFordAlgWorkspace GraphBellmanFordAlgWorkspace;
+
+GraphBellmanFordAlgWorkspace* GraphBellmanFordAlgWorkspaceCreate(Graph* g);
+
+//
+// A workspace over a CSR snapshot of g owned by the caller, shared, not
+// copied: it must outlive the workspace. Of the graph, creating it and
+// running it only read the scalar fields, never the adjacency lists, so
+// workspaces sharing one snapshot can be created by the threads that use
+// them
+//
+GraphBellmanFordAlgWorkspace* GraphBellmanFordAlgWorkspaceCreateShared(
+    Graph* g, const GraphCSR* adjacencias);
+
+void GraphBellmanFordAlgWorkspaceDestroy(GraphBellmanFordAlgWorkspace** p);
+
+//
+// The result belongs to the workspace: it is valid until the next run
+// and must NOT be destroyed
+// Returns NULL if a negative cycle is found, unless it was asked to be
+// reported
+//
+const GraphBellmanFordAlg* GraphBellmanFordAlgExecuteInWorkspace(
+    GraphBellmanFordAlgWorkspace* ws, unsigned int startVertex,
+    const GraphBellmanFordAlgOptions* options);
+
 // Getting the result
 
 int GraphBellmanFordAlgReached(const GraphBellmanFordAlg* p, unsigned int v);
 
+// Unweighted graphs: the number of edges
+// Returns -1, if v was not reached
 int GraphBellmanFordAlgDistance(const GraphBellmanFordAlg* p, unsigned int v);
 
+// Any graph: the sum of the weights
+// Returns INFINITY, if v was not reached
+double GraphBellmanFordAlgWeightedDistance(const GraphBellmanFordAlg* p,
+                                           unsigned int v);
+
+int GraphBellmanFordAlgHasNegativeCycle(const GraphBellmanFordAlg* p);
+
+//
+// returns an array of size (number of vertices on the cycle + 1)
+// element 0 stores the number of vertices, followed by the vertices, in the
+// order of the edges of the cycle
+// element 0 is 0, if no negative cycle was found
+//
+unsigned int* GraphBellmanFordAlgGetNegativeCycle(const GraphBellmanFordAlg* p);
+
 Stack* GraphBellmanFordAlgPathTo(const GraphBellmanFordAlg* p, unsigned int v);
 
+// Paths to many vertices, in one flat buffer
+// Built in time proportional to the total length of the paths: the common
+// prefixes are copied, not found again by walking up the tree
+
+typedef struct _GraphBellmanFordAlgPaths GraphBellmanFordAlgPaths;
+
+//
+// targets == NULL: the paths to every vertex, in vertex order
+// The path to a vertex that was not reached is empty
+//
+GraphBellmanFordAlgPaths* GraphBellmanFordAlgPathsTo(
+    const GraphBellmanFordAlg* p, const unsigned int* targets,
+    unsigned int numTargets);
+
+void GraphBellmanFordAlgPathsDestroy(GraphBellmanFordAlgPaths** p);
+
+unsigned int GraphBellmanFordAlgPathsGetNumPaths(
+    const GraphBellmanFordAlgPaths* paths);
+
+// The number of vertices on path i
+unsigned int GraphBellmanFordAlgPathsGetLength(
+    const GraphBellmanFordAlgPaths* paths, unsigned int i);
+
+// The vertices of path i, from the start vertex to the target
+// The array belongs to paths
+const unsigned int* GraphBellmanFordAlgPathsGetPath(
+    const GraphBellmanFordAlgPaths* paths, unsigned int i);
+
 // DISPLAYING on the console
 
+void GraphBellmanFordAlgStatsPrint(const GraphBellmanFordAlgStats* stats);
+
 void GraphBellmanFordAlgShowPath(const GraphBellmanFordAlg* p, unsigned int v);
 
 void GraphBellmanFordAlgDisplayDOT(const GraphBellmanFordAlg* p);
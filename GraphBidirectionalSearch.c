@@ -0,0 +1,293 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphBidirectionalSearch - Point-to-point shortest path queries
+//
+
+#include "GraphBidirectionalSearch.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Graph.h"
+#include "GraphCSR.h"
+#include "IndexedMinHeap.h"
+
+// One of the two searches
+struct _SearchSide {
+  const GraphCSR* csr;  // out-edges (forward) or in-edges (backward)
+  unsigned int* stamp;  // stamp[v] == epoch: v was reached in this query
+  double* distance;     // from s (forward) or to t (backward)
+  int* parent;          // the previous vertex on the path from s (forward)
+                        // the next vertex on the path to t (backward)
+  unsigned int* queue;  // BFS: vertices in order of discovery
+  unsigned int levelStart;  // BFS: the current level is
+  unsigned int queueEnd;    // queue[levelStart .. queueEnd-1]
+  MinHeap* heap;            // Dijkstra: reached, not yet settled vertices
+};
+
+struct _GraphBidirectionalSearch {
+  Graph* graph;
+  unsigned int numVertices;
+  GraphCSR* outEdges;
+  GraphCSR* inEdges;  // Same as outEdges, for an undirected graph
+  struct _SearchSide side[2];  // 0: forward, 1: backward
+  unsigned int epoch;
+  int meet;  // The vertex where the searches met, in the last query
+};
+
+static void _createSide(struct _SearchSide* side, const GraphCSR* csr,
+                        unsigned int n, int isWeighted) {
+  side->csr = csr;
+  side->stamp = (unsigned int*)calloc(n + 1, sizeof(unsigned int));
+  side->distance = (double*)malloc((n + 1) * sizeof(double));
+  side->parent = (int*)malloc((n + 1) * sizeof(int));
+  side->queue = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+  if (side->stamp == NULL || side->distance == NULL || side->parent == NULL ||
+      side->queue == NULL)
+    abort();
+  side->heap = isWeighted ? MinHeapCreate(n) : NULL;
+}
+
+static void _destroySide(struct _SearchSide* side) {
+  free(side->stamp);
+  free(side->distance);
+  free(side->parent);
+  free(side->queue);
+  if (side->heap != NULL) MinHeapDestroy(&side->heap);
+}
+
+GraphBidirectionalSearch* GraphBidirectionalSearchCreate(Graph* g) {
+  assert(g != NULL);
+
+  GraphBidirectionalSearch* bs =
+      (GraphBidirectionalSearch*)malloc(sizeof(struct _GraphBidirectionalSearch));
+  if (bs == NULL) abort();
+
+  bs->graph = g;
+  bs->numVertices = GraphGetNumVertices(g);
+  bs->outEdges = GraphCSRCreate(g);
+  bs->inEdges = GraphIsDigraph(g) ? GraphCSRCreateTranspose(bs->outEdges)
+                                  : bs->outEdges;
+
+  int isWeighted = GraphIsWeighted(g);
+  if (isWeighted) {
+    // Dijkstra requires non-negative weights
+    const double* weights = GraphCSRGetWeights(bs->outEdges);
+    for (unsigned int k = 0; k < GraphCSRGetNumArcs(bs->outEdges); k++) {
+      assert(weights[k] >= 0.0);
+    }
+    (void)weights;
+  }
+
+  _createSide(&bs->side[0], bs->outEdges, bs->numVertices, isWeighted);
+  _createSide(&bs->side[1], bs->inEdges, bs->numVertices, isWeighted);
+
+  bs->epoch = 0;
+  bs->meet = -1;
+
+  return bs;
+}
+
+void GraphBidirectionalSearchDestroy(GraphBidirectionalSearch** p) {
+  assert(*p != NULL);
+
+  GraphBidirectionalSearch* bs = *p;
+
+  _destroySide(&bs->side[0]);
+  _destroySide(&bs->side[1]);
+  if (bs->inEdges != bs->outEdges) GraphCSRDestroy(&bs->inEdges);
+  GraphCSRDestroy(&bs->outEdges);
+
+  free(*p);
+  *p = NULL;
+}
+
+// Start a new query: O(1), unless the epoch counter wraps around
+static void _newEpoch(GraphBidirectionalSearch* bs) {
+  bs->epoch++;
+  if (bs->epoch == 0) {
+    for (int i = 0; i < 2; i++) {
+      memset(bs->side[i].stamp, 0, bs->numVertices * sizeof(unsigned int));
+    }
+    bs->epoch = 1;
+  }
+}
+
+static void _reach(struct _SearchSide* side, unsigned int epoch,
+                   unsigned int v, double distance, int parent) {
+  side->stamp[v] = epoch;
+  side->distance[v] = distance;
+  side->parent[v] = parent;
+}
+
+// Expand one full level of a BFS side
+// Returns the best meeting distance found, or INFINITY
+static double _expandLevel(GraphBidirectionalSearch* bs,
+                           struct _SearchSide* side,
+                           const struct _SearchSide* other) {
+  const unsigned int* offsets = GraphCSRGetOffsets(side->csr);
+  const unsigned int* targets = GraphCSRGetTargets(side->csr);
+  unsigned int epoch = bs->epoch;
+
+  double best = INFINITY;
+  unsigned int levelEnd = side->queueEnd;
+  for (unsigned int i = side->levelStart; i < levelEnd; i++) {
+    unsigned int u = side->queue[i];
+    double next = side->distance[u] + 1.0;
+    for (unsigned int k = offsets[u]; k < offsets[u + 1]; k++) {
+      unsigned int x = targets[k];
+      if (side->stamp[x] == epoch) continue;
+      _reach(side, epoch, x, next, (int)u);
+      side->queue[side->queueEnd++] = x;
+      if (other->stamp[x] == epoch && next + other->distance[x] < best) {
+        best = next + other->distance[x];
+        bs->meet = (int)x;
+      }
+    }
+  }
+  side->levelStart = levelEnd;
+  return best;
+}
+
+static double _bidirectionalBFS(GraphBidirectionalSearch* bs) {
+  struct _SearchSide* forward = &bs->side[0];
+  struct _SearchSide* backward = &bs->side[1];
+
+  for (;;) {
+    unsigned int forwardSize = forward->queueEnd - forward->levelStart;
+    unsigned int backwardSize = backward->queueEnd - backward->levelStart;
+    if (forwardSize == 0 || backwardSize == 0) return INFINITY;
+
+    // Expand the smaller frontier
+    double best = forwardSize <= backwardSize
+                      ? _expandLevel(bs, forward, backward)
+                      : _expandLevel(bs, backward, forward);
+    // Every meeting on this level was examined: best is optimal
+    if (best < INFINITY) return best;
+  }
+}
+
+// Settle the closest vertex of one Dijkstra side
+static void _settleOne(GraphBidirectionalSearch* bs, struct _SearchSide* side,
+                       const struct _SearchSide* other, double* best) {
+  const unsigned int* offsets = GraphCSRGetOffsets(side->csr);
+  const unsigned int* targets = GraphCSRGetTargets(side->csr);
+  const double* weights = GraphCSRGetWeights(side->csr);
+  unsigned int epoch = bs->epoch;
+
+  unsigned int u = MinHeapRemoveMin(side->heap);
+  for (unsigned int k = offsets[u]; k < offsets[u + 1]; k++) {
+    unsigned int x = targets[k];
+    double next = side->distance[u] + weights[k];
+    if (side->stamp[x] == epoch && side->distance[x] <= next) continue;
+    _reach(side, epoch, x, next, (int)u);
+    MinHeapInsertOrDecrease(side->heap, x, next);
+    if (other->stamp[x] == epoch && next + other->distance[x] < *best) {
+      *best = next + other->distance[x];
+      bs->meet = (int)x;
+    }
+  }
+}
+
+static double _bidirectionalDijkstra(GraphBidirectionalSearch* bs) {
+  struct _SearchSide* forward = &bs->side[0];
+  struct _SearchSide* backward = &bs->side[1];
+
+  double best = INFINITY;
+  while (!MinHeapIsEmpty(forward->heap) && !MinHeapIsEmpty(backward->heap)) {
+    double forwardMin = MinHeapPeekMinKey(forward->heap);
+    double backwardMin = MinHeapPeekMinKey(backward->heap);
+    // No path through unsettled vertices can be shorter
+    if (forwardMin + backwardMin >= best) break;
+
+    if (forwardMin <= backwardMin) {
+      _settleOne(bs, forward, backward, &best);
+    } else {
+      _settleOne(bs, backward, forward, &best);
+    }
+  }
+  return best;
+}
+
+// Run a query; returns INFINITY if t is not reachable from s
+static double _search(GraphBidirectionalSearch* bs, unsigned int s,
+                      unsigned int t) {
+  assert(bs != NULL);
+  assert(s < bs->numVertices);
+  assert(t < bs->numVertices);
+
+  _newEpoch(bs);
+
+  struct _SearchSide* forward = &bs->side[0];
+  struct _SearchSide* backward = &bs->side[1];
+  _reach(forward, bs->epoch, s, 0.0, -1);
+  _reach(backward, bs->epoch, t, 0.0, -1);
+  bs->meet = (int)s;
+  if (s == t) return 0.0;
+
+  if (forward->heap == NULL) {
+    forward->queue[0] = s;
+    backward->queue[0] = t;
+    forward->levelStart = backward->levelStart = 0;
+    forward->queueEnd = backward->queueEnd = 1;
+    return _bidirectionalBFS(bs);
+  }
+
+  MinHeapClear(forward->heap);
+  MinHeapClear(backward->heap);
+  MinHeapInsert(forward->heap, s, 0.0);
+  MinHeapInsert(backward->heap, t, 0.0);
+  return _bidirectionalDijkstra(bs);
+}
+
+double GraphBidirectionalSearchDistance(GraphBidirectionalSearch* bs,
+                                        unsigned int s, unsigned int t) {
+  double distance = _search(bs, s, t);
+  return distance < INFINITY ? distance : -1.0;
+}
+
+unsigned int* GraphBidirectionalSearchPath(GraphBidirectionalSearch* bs,
+                                           unsigned int s, unsigned int t) {
+  double distance = _search(bs, s, t);
+  if (distance == INFINITY) {
+    return (unsigned int*)calloc(1, sizeof(unsigned int));
+  }
+
+  // Count the vertices on both halves of the path
+  unsigned int count = 0;
+  for (int v = bs->meet; v != -1; v = bs->side[0].parent[v]) count++;
+  for (int v = bs->side[1].parent[bs->meet]; v != -1;
+       v = bs->side[1].parent[v])
+    count++;
+
+  unsigned int* path =
+      (unsigned int*)malloc((count + 1) * sizeof(unsigned int));
+  if (path == NULL) abort();
+  path[0] = count;
+
+  // From the meeting vertex back to s, stored from right to left
+  unsigned int i = 0;
+  for (int v = bs->meet; v != -1; v = bs->side[0].parent[v]) i++;
+  unsigned int meetIndex = i;
+  for (int v = bs->meet; v != -1; v = bs->side[0].parent[v]) {
+    path[i--] = (unsigned int)v;
+  }
+  // From the meeting vertex on to t
+  i = meetIndex + 1;
+  for (int v = bs->side[1].parent[bs->meet]; v != -1;
+       v = bs->side[1].parent[v]) {
+    path[i++] = (unsigned int)v;
+  }
+
+  return path;
+}
+
+double GraphShortestDistance(Graph* g, unsigned int s, unsigned int t) {
+  GraphBidirectionalSearch* bs = GraphBidirectionalSearchCreate(g);
+  double distance = GraphBidirectionalSearchDistance(bs, s, t);
+  GraphBidirectionalSearchDestroy(&bs);
+  return distance;
+}
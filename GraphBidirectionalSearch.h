@@ -0,0 +1,52 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphBidirectionalSearch - Point-to-point shortest path queries
+//
+// Two searches run at the same time: forward from the source, on the
+// out-edges, and backward from the target, on the in-edges.
+// The query stops as soon as the searches meet on a shortest path, so only
+// a small region around the two end vertices is usually explored.
+// Unweighted graphs: bidirectional BFS.
+// Weighted graphs: bidirectional Dijkstra (weights must be non-negative).
+//
+
+#ifndef _GRAPH_BIDIRECTIONAL_SEARCH_
+#define _GRAPH_BIDIRECTIONAL_SEARCH_
+
+#include "Graph.h"
+
+typedef struct _GraphBidirectionalSearch GraphBidirectionalSearch;
+
+//
+// Takes a snapshot of the graph (out- and in-adjacencies) and allocates
+// every array once; queries allocate nothing and reset in O(1)
+// The snapshot is not updated if the graph changes
+//
+GraphBidirectionalSearch* GraphBidirectionalSearchCreate(Graph* g);
+
+void GraphBidirectionalSearchDestroy(GraphBidirectionalSearch** p);
+
+// Queries
+
+//
+// The length of a shortest path from s to t
+// (the number of edges, if the graph is unweighted)
+// Returns -1.0, if t is not reachable from s
+//
+double GraphBidirectionalSearchDistance(GraphBidirectionalSearch* bs,
+                                        unsigned int s, unsigned int t);
+
+//
+// returns an array of size (number of vertices on the path + 1)
+// element 0 stores the number of vertices on the path, followed by the
+// vertices, from s to t
+// element 0 is 0, if t is not reachable from s
+//
+unsigned int* GraphBidirectionalSearchPath(GraphBidirectionalSearch* bs,
+                                           unsigned int s, unsigned int t);
+
+// Single query, without keeping the snapshot
+double GraphShortestDistance(Graph* g, unsigned int s, unsigned int t);
+
+#endif  // _GRAPH_BIDIRECTIONAL_SEARCH_
@@ -0,0 +1,156 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphCSR - Compressed Sparse Row snapshot of a graph
+//
+
+#include "GraphCSR.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+
+struct _GraphCSR {
+  int isDigraph;
+  int isWeighted;
+  unsigned int numVertices;
+  unsigned int numArcs;   // Twice the number of edges, if undirected
+  unsigned int* offsets;  // Array of size (numVertices + 1)
+  unsigned int* targets;  // Array of size numArcs
+  double* weights;        // Array of size numArcs, or NULL if unweighted
+};
+
+static GraphCSR* _allocCSR(unsigned int numVertices, unsigned int numArcs,
+                           int isDigraph, int isWeighted) {
+  GraphCSR* csr = (GraphCSR*)malloc(sizeof(struct _GraphCSR));
+  if (csr == NULL) abort();
+
+  csr->isDigraph = isDigraph;
+  csr->isWeighted = isWeighted;
+  csr->numVertices = numVertices;
+  csr->numArcs = numArcs;
+
+  csr->offsets = (unsigned int*)calloc(numVertices + 1, sizeof(unsigned int));
+  // Avoid malloc(0) for graphs without edges
+  csr->targets = (unsigned int*)malloc((numArcs + 1) * sizeof(unsigned int));
+  if (csr->offsets == NULL || csr->targets == NULL) abort();
+
+  csr->weights = NULL;
+  if (isWeighted) {
+    csr->weights = (double*)malloc((numArcs + 1) * sizeof(double));
+    if (csr->weights == NULL) abort();
+  }
+
+  return csr;
+}
+
+GraphCSR* GraphCSRCreate(const Graph* g) {
+  assert(g != NULL);
+
+  unsigned int numVertices = GraphGetNumVertices(g);
+  unsigned int numArcs = GraphGetNumEdges(g);
+  if (GraphIsDigraph(g) == 0) {
+    numArcs *= 2;
+  }
+
+  GraphCSR* csr =
+      _allocCSR(numVertices, numArcs, GraphIsDigraph(g), GraphIsWeighted(g));
+
+  // The vertices are visited by increasing index,
+  // so each ListMove inside the Graph functions is O(1)
+  unsigned int k = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    csr->offsets[v] = k;
+
+    unsigned int* adjacents = GraphGetAdjacentsTo(g, v);
+    for (unsigned int i = 1; i <= adjacents[0]; i++) {
+      csr->targets[k + i - 1] = adjacents[i];
+    }
+
+    if (csr->isWeighted) {
+      double* distances = GraphGetDistancesToAdjacents(g, v);
+      for (unsigned int i = 1; i <= adjacents[0]; i++) {
+        csr->weights[k + i - 1] = distances[i];
+      }
+      free(distances);
+    }
+
+    k += adjacents[0];
+    free(adjacents);
+  }
+  csr->offsets[numVertices] = k;
+
+  assert(k == numArcs);
+
+  return csr;
+}
+
+GraphCSR* GraphCSRCreateTranspose(const GraphCSR* csr) {
+  assert(csr != NULL);
+
+  unsigned int n = csr->numVertices;
+  GraphCSR* t = _allocCSR(n, csr->numArcs, csr->isDigraph, csr->isWeighted);
+
+  // Counting sort of the arcs by their target vertex
+  for (unsigned int k = 0; k < csr->numArcs; k++) {
+    t->offsets[csr->targets[k] + 1]++;
+  }
+  for (unsigned int v = 0; v < n; v++) {
+    t->offsets[v + 1] += t->offsets[v];
+  }
+
+  unsigned int* next = (unsigned int*)malloc((n + 1) * sizeof(unsigned int));
+  if (next == NULL) abort();
+  for (unsigned int v = 0; v < n; v++) {
+    next[v] = t->offsets[v];
+  }
+
+  // Sources are visited by increasing index: the in-lists come out sorted
+  for (unsigned int v = 0; v < n; v++) {
+    for (unsigned int k = csr->offsets[v]; k < csr->offsets[v + 1]; k++) {
+      unsigned int pos = next[csr->targets[k]]++;
+      t->targets[pos] = v;
+      if (t->isWeighted) {
+        t->weights[pos] = csr->weights[k];
+      }
+    }
+  }
+
+  free(next);
+
+  return t;
+}
+
+void GraphCSRDestroy(GraphCSR** p) {
+  assert(*p != NULL);
+
+  GraphCSR* aux = *p;
+
+  free(aux->offsets);
+  free(aux->targets);
+  free(aux->weights);
+
+  free(*p);
+  *p = NULL;
+}
+
+int GraphCSRIsDigraph(const GraphCSR* csr) { return csr->isDigraph; }
+
+int GraphCSRIsWeighted(const GraphCSR* csr) { return csr->isWeighted; }
+
+unsigned int GraphCSRGetNumVertices(const GraphCSR* csr) {
+  return csr->numVertices;
+}
+
+unsigned int GraphCSRGetNumArcs(const GraphCSR* csr) { return csr->numArcs; }
+
+const unsigned int* GraphCSRGetOffsets(const GraphCSR* csr) {
+  return csr->offsets;
+}
+
+const unsigned int* GraphCSRGetTargets(const GraphCSR* csr) {
+  return csr->targets;
+}
+
+const double* GraphCSRGetWeights(const GraphCSR* csr) { return csr->weights; }
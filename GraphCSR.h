@@ -0,0 +1,49 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphCSR - Compressed Sparse Row snapshot of a graph
+//
+// The adjacency lists of a graph are copied into three flat arrays, so that
+// the traversal engines can scan the neighbours of a vertex without walking
+// linked lists or allocating memory.
+// For an undirected graph, each edge is stored as two arcs.
+// The snapshot is read-only: it is NOT updated when edges are added to the
+// original graph.
+//
+
+#ifndef _GRAPH_CSR_
+#define _GRAPH_CSR_
+
+#include "Graph.h"
+
+typedef struct _GraphCSR GraphCSR;
+
+GraphCSR* GraphCSRCreate(const Graph* g);
+
+//
+// The arcs reversed: the neighbours of v are its in-neighbours
+//
+GraphCSR* GraphCSRCreateTranspose(const GraphCSR* csr);
+
+void GraphCSRDestroy(GraphCSR** p);
+
+int GraphCSRIsDigraph(const GraphCSR* csr);
+
+int GraphCSRIsWeighted(const GraphCSR* csr);
+
+unsigned int GraphCSRGetNumVertices(const GraphCSR* csr);
+
+unsigned int GraphCSRGetNumArcs(const GraphCSR* csr);
+
+// Flat arrays
+// The neighbours of v are targets[offsets[v]] ... targets[offsets[v+1]-1],
+// sorted by increasing index; weights (NULL if unweighted) is parallel to
+// targets.
+
+const unsigned int* GraphCSRGetOffsets(const GraphCSR* csr);
+
+const unsigned int* GraphCSRGetTargets(const GraphCSR* csr);
+
+const double* GraphCSRGetWeights(const GraphCSR* csr);
+
+#endif  // _GRAPH_CSR_
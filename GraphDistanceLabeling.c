@@ -0,0 +1,581 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceLabeling - Exact distances, through a 2-hop labeling
+//
+
+#include "GraphDistanceLabeling.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphCSR.h"
+#include "IndexedMinHeap.h"
+
+#define LABELING_MAGIC 0x314C4C50u  // "PLL1"
+
+// The labels of all vertices, as flat arrays: the label of v is
+// hubs[offsets[v]] ... hubs[offsets[v+1]-1], by increasing hub
+// The hubs are numbered by their rank in the search order
+typedef struct {
+  size_t* offsets;      // numVertices + 1
+  unsigned int* hubs;
+  unsigned int* hops;   // Unweighted graphs
+  double* weights;      // Weighted graphs
+} _Labels;
+
+struct _GraphDistanceLabeling {
+  unsigned int numVertices;
+  int isDigraph;
+  int isWeighted;
+  _Labels* in;   // Distances from the hubs
+  _Labels* out;  // Distances to the hubs; the same as in, if undirected
+};
+
+// A label under construction
+typedef struct {
+  unsigned int size;
+  unsigned int capacity;
+  unsigned int* hubs;
+  double* distances;
+} _GrowingLabel;
+
+// The memory of one search, reused by all of them
+typedef struct {
+  double* distance;        // INFINITY, if not reached
+  unsigned int* reached;   // The vertices reached, to reset distance
+  unsigned int numReached;
+  MinHeap* heap;           // Weighted graphs
+} _SearchSpace;
+
+typedef struct {
+  unsigned int vertex;
+  unsigned int degree;
+} _VertexDegree;
+
+static void _append(_GrowingLabel* label, unsigned int hub, double distance) {
+  if (label->size == label->capacity) {
+    label->capacity = label->capacity == 0 ? 4 : 2 * label->capacity;
+    label->hubs = (unsigned int*)realloc(
+        label->hubs, label->capacity * sizeof(unsigned int));
+    label->distances = (double*)realloc(label->distances,
+                                        label->capacity * sizeof(double));
+    if (label->hubs == NULL || label->distances == NULL) abort();
+  }
+  label->hubs[label->size] = hub;
+  label->distances[label->size] = distance;
+  label->size++;
+}
+
+// Decreasing degree, then increasing index
+static int _compareDegrees(const void* a, const void* b) {
+  const _VertexDegree* x = (const _VertexDegree*)a;
+  const _VertexDegree* y = (const _VertexDegree*)b;
+  if (x->degree != y->degree) return x->degree > y->degree ? -1 : 1;
+  return x->vertex < y->vertex ? -1 : (x->vertex > y->vertex);
+}
+
+// The search order: in- plus out-degree, for a digraph
+static unsigned int* _searchOrder(const GraphCSR* forward,
+                                  const GraphCSR* backward) {
+  unsigned int numVertices = GraphCSRGetNumVertices(forward);
+  const unsigned int* outOffsets = GraphCSRGetOffsets(forward);
+  const unsigned int* inOffsets =
+      backward != NULL ? GraphCSRGetOffsets(backward) : NULL;
+
+  _VertexDegree* degrees =
+      (_VertexDegree*)malloc((numVertices + 1) * sizeof(_VertexDegree));
+  unsigned int* order =
+      (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  if (degrees == NULL || order == NULL) abort();
+
+  for (unsigned int v = 0; v < numVertices; v++) {
+    degrees[v].vertex = v;
+    degrees[v].degree = outOffsets[v + 1] - outOffsets[v];
+    if (inOffsets != NULL) degrees[v].degree += inOffsets[v + 1] - inOffsets[v];
+  }
+  qsort(degrees, numVertices, sizeof(_VertexDegree), _compareDegrees);
+  for (unsigned int r = 0; r < numVertices; r++) {
+    order[r] = degrees[r].vertex;
+  }
+
+  free(degrees);
+  return order;
+}
+
+// The shortest distance the label gives, through the hubs whose distances
+// from (or to) the root are in rootDistances
+static double _labelDistance(const _GrowingLabel* label,
+                             const double* rootDistances) {
+  double best = INFINITY;
+  for (unsigned int i = 0; i < label->size; i++) {
+    double d = rootDistances[label->hubs[i]] + label->distances[i];
+    if (d < best) best = d;
+  }
+  return best;
+}
+
+static void _reach(_SearchSpace* s, unsigned int v, double distance) {
+  if (s->distance[v] == INFINITY) s->reached[s->numReached++] = v;
+  s->distance[v] = distance;
+}
+
+//
+// Search from the root, the hub of the given rank, along the arcs of csr
+// Every vertex reached gets (rank, distance) in its label, unless the
+// labels built so far already give a distance as short: then the search
+// does not go beyond it
+// rootDistances: the distances between the root and the previous hubs,
+// from its label in the opposite direction
+//
+static void _prunedSearch(const GraphCSR* csr, unsigned int root,
+                          unsigned int rank, _GrowingLabel* labels,
+                          const double* rootDistances, _SearchSpace* s) {
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+  const double* weights = GraphCSRGetWeights(csr);
+
+  s->numReached = 0;
+  _reach(s, root, 0.0);
+
+  if (weights == NULL) {
+    // BFS: the vertices reached are the queue
+    for (unsigned int head = 0; head < s->numReached; head++) {
+      unsigned int v = s->reached[head];
+      double d = s->distance[v];
+      if (_labelDistance(&labels[v], rootDistances) <= d) continue;
+      _append(&labels[v], rank, d);
+      for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+        if (s->distance[targets[k]] == INFINITY) {
+          _reach(s, targets[k], d + 1.0);
+        }
+      }
+    }
+  } else {
+    MinHeapInsert(s->heap, root, 0.0);
+    while (!MinHeapIsEmpty(s->heap)) {
+      unsigned int v = MinHeapRemoveMin(s->heap);
+      double d = s->distance[v];
+      if (_labelDistance(&labels[v], rootDistances) <= d) continue;
+      _append(&labels[v], rank, d);
+      for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+        unsigned int w = targets[k];
+        if (d + weights[k] < s->distance[w]) {
+          _reach(s, w, d + weights[k]);
+          MinHeapInsertOrDecrease(s->heap, w, d + weights[k]);
+        }
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < s->numReached; i++) {
+    s->distance[s->reached[i]] = INFINITY;
+  }
+}
+
+static void _destroyLabels(_Labels* labels) {
+  free(labels->offsets);
+  free(labels->hubs);
+  free(labels->hops);
+  free(labels->weights);
+  free(labels);
+}
+
+// NULL if there is not enough memory
+static _Labels* _allocLabels(unsigned int numVertices, size_t numEntries,
+                             int isWeighted) {
+  _Labels* labels = (_Labels*)malloc(sizeof(_Labels));
+  if (labels == NULL) return NULL;
+  // Avoid malloc(0) for empty indexes
+  labels->offsets = (size_t*)malloc(((size_t)numVertices + 1) * sizeof(size_t));
+  labels->hubs = (unsigned int*)malloc((numEntries + 1) * sizeof(unsigned int));
+  labels->hops = NULL;
+  labels->weights = NULL;
+  if (isWeighted) {
+    labels->weights = (double*)malloc((numEntries + 1) * sizeof(double));
+  } else {
+    labels->hops =
+        (unsigned int*)malloc((numEntries + 1) * sizeof(unsigned int));
+  }
+  if (labels->offsets == NULL || labels->hubs == NULL ||
+      (labels->hops == NULL && labels->weights == NULL)) {
+    _destroyLabels(labels);
+    return NULL;
+  }
+  return labels;
+}
+
+// Copies the labels under construction into flat arrays, and frees them
+static _Labels* _flatten(_GrowingLabel* growing, unsigned int numVertices,
+                         int isWeighted) {
+  size_t numEntries = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    numEntries += growing[v].size;
+  }
+
+  _Labels* labels = _allocLabels(numVertices, numEntries, isWeighted);
+  if (labels == NULL) abort();
+  size_t next = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    labels->offsets[v] = next;
+    for (unsigned int i = 0; i < growing[v].size; i++, next++) {
+      labels->hubs[next] = growing[v].hubs[i];
+      if (isWeighted) {
+        labels->weights[next] = growing[v].distances[i];
+      } else {
+        labels->hops[next] = (unsigned int)growing[v].distances[i];
+      }
+    }
+    free(growing[v].hubs);
+    free(growing[v].distances);
+  }
+  labels->offsets[numVertices] = next;
+
+  return labels;
+}
+
+static GraphDistanceLabeling* _alloc(unsigned int numVertices, int isDigraph,
+                                     int isWeighted) {
+  GraphDistanceLabeling* p =
+      (GraphDistanceLabeling*)malloc(sizeof(struct _GraphDistanceLabeling));
+  if (p == NULL) abort();
+  p->numVertices = numVertices;
+  p->isDigraph = isDigraph;
+  p->isWeighted = isWeighted;
+  p->in = NULL;
+  p->out = NULL;
+  return p;
+}
+
+GraphDistanceLabeling* GraphDistanceLabelingCreate(const Graph* g) {
+  assert(g != NULL);
+
+  GraphCSR* forward = GraphCSRCreate(g);
+  unsigned int numVertices = GraphCSRGetNumVertices(forward);
+  int isDigraph = GraphCSRIsDigraph(forward);
+  int isWeighted = GraphCSRIsWeighted(forward);
+
+  if (isWeighted) {
+    const double* weights = GraphCSRGetWeights(forward);
+    for (unsigned int k = 0; k < GraphCSRGetNumArcs(forward); k++) {
+      if (weights[k] < 0.0) {
+        GraphCSRDestroy(&forward);
+        return NULL;
+      }
+    }
+  }
+  GraphCSR* backward = isDigraph ? GraphCSRCreateTranspose(forward) : NULL;
+
+  unsigned int* order = _searchOrder(forward, backward);
+
+  // Avoid malloc(0) for graphs without vertices
+  _GrowingLabel* in =
+      (_GrowingLabel*)calloc(numVertices + 1, sizeof(_GrowingLabel));
+  _GrowingLabel* out =
+      isDigraph ? (_GrowingLabel*)calloc(numVertices + 1, sizeof(_GrowingLabel))
+                : in;
+  double* rootDistances = (double*)malloc((numVertices + 1) * sizeof(double));
+  _SearchSpace s;
+  s.distance = (double*)malloc((numVertices + 1) * sizeof(double));
+  s.reached = (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  s.heap = isWeighted ? MinHeapCreate(numVertices) : NULL;
+  if (in == NULL || out == NULL || rootDistances == NULL ||
+      s.distance == NULL || s.reached == NULL) {
+    abort();
+  }
+  for (unsigned int v = 0; v < numVertices; v++) {
+    rootDistances[v] = INFINITY;
+    s.distance[v] = INFINITY;
+  }
+
+  for (unsigned int rank = 0; rank < numVertices; rank++) {
+    unsigned int root = order[rank];
+
+    // Forward: d(root, v) goes into the in-label of v; the previous hubs
+    // give d(root, hub) + d(hub, v)
+    _GrowingLabel* rootLabel = &out[root];
+    for (unsigned int i = 0; i < rootLabel->size; i++) {
+      rootDistances[rootLabel->hubs[i]] = rootLabel->distances[i];
+    }
+    _prunedSearch(forward, root, rank, in, rootDistances, &s);
+    for (unsigned int i = 0; i < rootLabel->size; i++) {
+      rootDistances[rootLabel->hubs[i]] = INFINITY;
+    }
+
+    if (!isDigraph) continue;
+
+    // Backward: d(v, root) goes into the out-label of v
+    rootLabel = &in[root];
+    for (unsigned int i = 0; i < rootLabel->size; i++) {
+      rootDistances[rootLabel->hubs[i]] = rootLabel->distances[i];
+    }
+    _prunedSearch(backward, root, rank, out, rootDistances, &s);
+    for (unsigned int i = 0; i < rootLabel->size; i++) {
+      rootDistances[rootLabel->hubs[i]] = INFINITY;
+    }
+  }
+
+  GraphDistanceLabeling* p = _alloc(numVertices, isDigraph, isWeighted);
+  p->in = _flatten(in, numVertices, isWeighted);
+  p->out = isDigraph ? _flatten(out, numVertices, isWeighted) : p->in;
+
+  free(in);
+  if (isDigraph) free(out);
+  free(rootDistances);
+  free(s.distance);
+  free(s.reached);
+  if (s.heap != NULL) MinHeapDestroy(&s.heap);
+  free(order);
+  GraphCSRDestroy(&forward);
+  if (backward != NULL) GraphCSRDestroy(&backward);
+
+  return p;
+}
+
+void GraphDistanceLabelingDestroy(GraphDistanceLabeling** p) {
+  assert(*p != NULL);
+
+  GraphDistanceLabeling* aux = *p;
+  if (aux->out != NULL && aux->out != aux->in) _destroyLabels(aux->out);
+  if (aux->in != NULL) _destroyLabels(aux->in);
+
+  free(*p);
+  *p = NULL;
+}
+
+// Save and load
+
+static int _saveLabels(const _Labels* labels, unsigned int numVertices,
+                       int isWeighted, FILE* f) {
+  size_t numEntries = labels->offsets[numVertices];
+  if (fwrite(labels->offsets, sizeof(size_t), numVertices + 1, f) !=
+          numVertices + 1 ||
+      fwrite(labels->hubs, sizeof(unsigned int), numEntries, f) != numEntries) {
+    return 0;
+  }
+  if (isWeighted) {
+    return fwrite(labels->weights, sizeof(double), numEntries, f) == numEntries;
+  }
+  return fwrite(labels->hops, sizeof(unsigned int), numEntries, f) ==
+         numEntries;
+}
+
+int GraphDistanceLabelingSave(const GraphDistanceLabeling* p, FILE* f) {
+  assert(p != NULL);
+  assert(f != NULL);
+
+  uint32_t header[4] = {LABELING_MAGIC, p->numVertices, (uint32_t)p->isDigraph,
+                        (uint32_t)p->isWeighted};
+  if (fwrite(header, sizeof(uint32_t), 4, f) != 4) return 0;
+  if (!_saveLabels(p->in, p->numVertices, p->isWeighted, f)) return 0;
+  if (p->isDigraph && !_saveLabels(p->out, p->numVertices, p->isWeighted, f)) {
+    return 0;
+  }
+  return fflush(f) == 0;
+}
+
+// The number of bytes from the current position to the end of the file;
+// SIZE_MAX if the stream cannot seek
+static size_t _remainingBytes(FILE* f) {
+  long position = ftell(f);
+  if (position < 0 || fseek(f, 0, SEEK_END) != 0) return SIZE_MAX;
+  long end = ftell(f);
+  if (fseek(f, position, SEEK_SET) != 0 || end < position) return SIZE_MAX;
+  return (size_t)(end - position);
+}
+
+// NULL if the labels cannot be read, or are not sorted by hub
+// The sizes read are checked against the bytes left in the file, *remaining,
+// before anything is allocated for them
+static _Labels* _loadLabels(unsigned int numVertices, int isWeighted,
+                            size_t* remaining, FILE* f) {
+  size_t numOffsets = (size_t)numVertices + 1;
+  if (numOffsets > *remaining / sizeof(size_t)) return NULL;
+  size_t* offsets = (size_t*)malloc(numOffsets * sizeof(size_t));
+  if (offsets == NULL) return NULL;
+  if (fread(offsets, sizeof(size_t), numOffsets, f) != numOffsets ||
+      offsets[0] != 0) {
+    free(offsets);
+    return NULL;
+  }
+  *remaining -= numOffsets * sizeof(size_t);
+  // A label has at most one entry per hub
+  for (unsigned int v = 0; v < numVertices; v++) {
+    if (offsets[v + 1] < offsets[v] ||
+        offsets[v + 1] - offsets[v] > numVertices) {
+      free(offsets);
+      return NULL;
+    }
+  }
+
+  size_t numEntries = offsets[numVertices];
+  size_t entryBytes =
+      sizeof(unsigned int) + (isWeighted ? sizeof(double) : sizeof(unsigned int));
+  if (numEntries > *remaining / entryBytes) {
+    free(offsets);
+    return NULL;
+  }
+  _Labels* labels = _allocLabels(numVertices, numEntries, isWeighted);
+  if (labels == NULL) {
+    free(offsets);
+    return NULL;
+  }
+  free(labels->offsets);
+  labels->offsets = offsets;
+
+  int valid =
+      fread(labels->hubs, sizeof(unsigned int), numEntries, f) == numEntries;
+  if (valid && isWeighted) {
+    valid = fread(labels->weights, sizeof(double), numEntries, f) == numEntries;
+  } else if (valid) {
+    valid = fread(labels->hops, sizeof(unsigned int), numEntries, f) ==
+            numEntries;
+  }
+  *remaining -= numEntries * entryBytes;
+  for (unsigned int v = 0; valid && v < numVertices; v++) {
+    for (size_t i = offsets[v]; i < offsets[v + 1]; i++) {
+      if (labels->hubs[i] >= numVertices ||
+          (i > offsets[v] && labels->hubs[i] <= labels->hubs[i - 1])) {
+        valid = 0;
+        break;
+      }
+    }
+  }
+
+  if (!valid) {
+    _destroyLabels(labels);
+    return NULL;
+  }
+  return labels;
+}
+
+GraphDistanceLabeling* GraphDistanceLabelingLoad(FILE* f) {
+  assert(f != NULL);
+
+  uint32_t header[4];
+  if (fread(header, sizeof(uint32_t), 4, f) != 4 ||
+      header[0] != LABELING_MAGIC || header[2] > 1 || header[3] > 1) {
+    return NULL;
+  }
+
+  size_t remaining = _remainingBytes(f);
+  GraphDistanceLabeling* p = _alloc(header[1], (int)header[2], (int)header[3]);
+  p->in = _loadLabels(p->numVertices, p->isWeighted, &remaining, f);
+  if (p->in != NULL && p->isDigraph) {
+    p->out = _loadLabels(p->numVertices, p->isWeighted, &remaining, f);
+  } else {
+    p->out = p->in;
+  }
+
+  if (p->in == NULL || p->out == NULL) {
+    GraphDistanceLabelingDestroy(&p);
+  }
+  return p;
+}
+
+// Getters
+
+unsigned int GraphDistanceLabelingGetNumVertices(
+    const GraphDistanceLabeling* p) {
+  assert(p != NULL);
+  return p->numVertices;
+}
+
+int GraphDistanceLabelingIsDigraph(const GraphDistanceLabeling* p) {
+  assert(p != NULL);
+  return p->isDigraph;
+}
+
+int GraphDistanceLabelingIsWeighted(const GraphDistanceLabeling* p) {
+  assert(p != NULL);
+  return p->isWeighted;
+}
+
+size_t GraphDistanceLabelingGetNumEntries(const GraphDistanceLabeling* p) {
+  assert(p != NULL);
+
+  size_t numEntries = p->in->offsets[p->numVertices];
+  if (p->isDigraph) numEntries += p->out->offsets[p->numVertices];
+  return numEntries;
+}
+
+size_t GraphDistanceLabelingGetMemoryBytes(const GraphDistanceLabeling* p) {
+  assert(p != NULL);
+
+  size_t entryBytes =
+      sizeof(unsigned int) + (p->isWeighted ? sizeof(double) : sizeof(unsigned int));
+  size_t offsetBytes = ((size_t)p->numVertices + 1) * sizeof(size_t);
+  size_t bytes = GraphDistanceLabelingGetNumEntries(p) * entryBytes;
+  return bytes + (p->isDigraph ? 2 : 1) * offsetBytes;
+}
+
+// Queries: merging the out-label of v with the in-label of w
+
+int GraphDistanceLabelingGetDistanceVW(const GraphDistanceLabeling* p,
+                                       unsigned int v, unsigned int w) {
+  assert(p != NULL);
+  assert(!p->isWeighted);
+  assert(v < p->numVertices && w < p->numVertices);
+
+  if (v == w) return 0;
+
+  const _Labels* out = p->out;
+  const _Labels* in = p->in;
+  size_t i = out->offsets[v];
+  size_t iEnd = out->offsets[v + 1];
+  size_t j = in->offsets[w];
+  size_t jEnd = in->offsets[w + 1];
+  unsigned int best = UINT_MAX;
+  while (i < iEnd && j < jEnd) {
+    unsigned int hubV = out->hubs[i];
+    unsigned int hubW = in->hubs[j];
+    if (hubV == hubW) {
+      unsigned int d = out->hops[i++] + in->hops[j++];
+      if (d < best) best = d;
+    } else if (hubV < hubW) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+
+  return best == UINT_MAX ? -1 : (int)best;
+}
+
+double GraphDistanceLabelingGetWeightedDistanceVW(
+    const GraphDistanceLabeling* p, unsigned int v, unsigned int w) {
+  assert(p != NULL);
+  assert(v < p->numVertices && w < p->numVertices);
+
+  if (!p->isWeighted) {
+    int d = GraphDistanceLabelingGetDistanceVW(p, v, w);
+    return d < 0 ? INFINITY : (double)d;
+  }
+  if (v == w) return 0.0;
+
+  const _Labels* out = p->out;
+  const _Labels* in = p->in;
+  size_t i = out->offsets[v];
+  size_t iEnd = out->offsets[v + 1];
+  size_t j = in->offsets[w];
+  size_t jEnd = in->offsets[w + 1];
+  double best = INFINITY;
+  while (i < iEnd && j < jEnd) {
+    unsigned int hubV = out->hubs[i];
+    unsigned int hubW = in->hubs[j];
+    if (hubV == hubW) {
+      double d = out->weights[i++] + in->weights[j++];
+      if (d < best) best = d;
+    } else if (hubV < hubW) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+
+  return best;
+}
@@ -0,0 +1,64 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceLabeling - Exact distances, through a 2-hop labeling
+//
+// Pruned landmark labeling: every vertex v gets a label, a list of pairs
+// (hub, distance), such that for every pair of vertices v and w some
+// shortest path from v to w goes through a hub in the out-label of v and
+// in the in-label of w. A query merges the two labels, sorted by hub, in
+// O(size of the labels), and is exact.
+// The labels are built by one search (BFS, or Dijkstra on weighted graphs)
+// from each vertex, by decreasing degree; a search is pruned at the
+// vertices whose distance the labels built so far already give. The high
+// degree vertices cover most shortest paths, so the labels stay short.
+// For an undirected graph, the in- and out-labels are the same.
+// Weights must not be negative.
+// Queries only read the index: they may run concurrently.
+//
+
+#ifndef _GRAPH_DISTANCE_LABELING_
+#define _GRAPH_DISTANCE_LABELING_
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "Graph.h"
+
+typedef struct _GraphDistanceLabeling GraphDistanceLabeling;
+
+// Returns NULL if the graph has a negative weight
+GraphDistanceLabeling* GraphDistanceLabelingCreate(const Graph* g);
+
+void GraphDistanceLabelingDestroy(GraphDistanceLabeling** p);
+
+//
+// Binary format, in the byte order of the machine
+// Save returns 0 if writing fails
+// Load returns NULL if reading fails, or the contents are not an index;
+// the sizes in the file are checked against its length before allocating
+//
+int GraphDistanceLabelingSave(const GraphDistanceLabeling* p, FILE* f);
+
+GraphDistanceLabeling* GraphDistanceLabelingLoad(FILE* f);
+
+unsigned int GraphDistanceLabelingGetNumVertices(const GraphDistanceLabeling* p);
+
+int GraphDistanceLabelingIsDigraph(const GraphDistanceLabeling* p);
+
+int GraphDistanceLabelingIsWeighted(const GraphDistanceLabeling* p);
+
+// Total number of (hub, distance) pairs, over all labels
+size_t GraphDistanceLabelingGetNumEntries(const GraphDistanceLabeling* p);
+
+size_t GraphDistanceLabelingGetMemoryBytes(const GraphDistanceLabeling* p);
+
+// Unweighted graphs only: the number of edges, or -1 if w is not reachable
+int GraphDistanceLabelingGetDistanceVW(const GraphDistanceLabeling* p,
+                                       unsigned int v, unsigned int w);
+
+// INFINITY if w is not reachable from v
+double GraphDistanceLabelingGetWeightedDistanceVW(
+    const GraphDistanceLabeling* p, unsigned int v, unsigned int w);
+
+#endif  // _GRAPH_DISTANCE_LABELING_
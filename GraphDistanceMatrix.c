@@ -0,0 +1,411 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceMatrix - Dense matrix of integer distances between vertices
+//
+
+#include "GraphDistanceMatrix.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define CACHE_LINE_BYTES 64
+
+struct _GraphDistanceMatrix {
+  unsigned int numRows;
+  unsigned int firstRow;     // The rows are firstRow .. firstRow+numRows-1
+  unsigned int numVertices;  // Per row
+  unsigned int entryBytes;   // 1, 2 or 4; 8: doubles
+  unsigned int maxDistance;
+  size_t numBytes;           // Rounded up to a multiple of the cache line
+  unsigned char* data;       // Row-major: entry (v, w) is
+                             // (v - firstRow) * numVertices + w
+  int isMapped;              // 1: data is a read-only file mapping
+  int isSymmetric;           // 1: only the entries (v, w) with v <= w,
+                             // packed row by row
+};
+
+static GraphDistanceMatrix* _alloc(unsigned int numRows,
+                                   unsigned int numVertices,
+                                   unsigned int entryBytes,
+                                   unsigned int maxDistance,
+                                   int isSymmetric) {
+  GraphDistanceMatrix* m =
+      (GraphDistanceMatrix*)malloc(sizeof(struct _GraphDistanceMatrix));
+  if (m == NULL) abort();
+
+  m->numRows = numRows;
+  m->firstRow = 0;
+  m->numVertices = numVertices;
+  m->entryBytes = entryBytes;
+  m->maxDistance = maxDistance;
+
+  m->isSymmetric = isSymmetric;
+  size_t numEntries = isSymmetric
+                          ? (size_t)numVertices * (numVertices + 1) / 2
+                          : (size_t)numRows * numVertices;
+  m->numBytes = numEntries * m->entryBytes;
+  // Avoid a zero-sized allocation for graphs without vertices
+  m->numBytes = (m->numBytes / CACHE_LINE_BYTES + 1) * CACHE_LINE_BYTES;
+  m->data = NULL;
+  m->isMapped = 0;
+
+  return m;
+}
+
+static GraphDistanceMatrix* _create(unsigned int numRows,
+                                    unsigned int numVertices,
+                                    unsigned int entryBytes,
+                                    unsigned int maxDistance,
+                                    int isSymmetric) {
+  GraphDistanceMatrix* m =
+      _alloc(numRows, numVertices, entryBytes, maxDistance, isSymmetric);
+
+  m->data = (unsigned char*)aligned_alloc(CACHE_LINE_BYTES, m->numBytes);
+  if (m->data == NULL) abort();
+
+  return m;
+}
+
+// The offset of entry (v, w)
+static inline size_t _index(const GraphDistanceMatrix* m, unsigned int v,
+                            unsigned int w) {
+  assert(v >= m->firstRow && v - m->firstRow < m->numRows);
+  assert(w < m->numVertices);
+  if (m->isSymmetric) {
+    if (v > w) {
+      unsigned int aux = v;
+      v = w;
+      w = aux;
+    }
+    // Row v starts after rows 0 .. v-1, of n, n-1, ..., n-v+1 entries
+    return (size_t)v * (2 * (size_t)m->numVertices - v + 1) / 2 + (w - v);
+  }
+  return (size_t)(v - m->firstRow) * m->numVertices + w;
+}
+
+// Every entry becomes unreachable
+static void _clearAll(GraphDistanceMatrix* m) {
+  if (m->entryBytes != sizeof(double)) {
+    // All ones, for every width
+    memset(m->data, 0xFF, m->numBytes);
+    return;
+  }
+  double* entries = (double*)m->data;
+  for (size_t i = 0; i < m->numBytes / sizeof(double); i++) {
+    entries[i] = INFINITY;
+  }
+}
+
+unsigned int GraphDistanceMatrixEntryBytesFor(unsigned int maxDistance) {
+  assert(maxDistance < (unsigned int)INT_MAX);
+
+  // The all-ones pattern of each width is the sentinel
+  if (maxDistance < UINT8_MAX) return 1;
+  if (maxDistance < UINT16_MAX) return 2;
+  return 4;
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateRows(unsigned int numRows,
+                                                   unsigned int numVertices,
+                                                   unsigned int maxDistance) {
+  GraphDistanceMatrix* m =
+      _create(numRows, numVertices,
+              GraphDistanceMatrixEntryBytesFor(maxDistance), maxDistance, 0);
+
+  _clearAll(m);
+
+  return m;
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeightedRows(
+    unsigned int numRows, unsigned int numVertices) {
+  GraphDistanceMatrix* m =
+      _create(numRows, numVertices, sizeof(double), 0, 0);
+
+  _clearAll(m);
+
+  return m;
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateSymmetric(
+    unsigned int numVertices, unsigned int maxDistance) {
+  GraphDistanceMatrix* m =
+      _create(numVertices, numVertices,
+              GraphDistanceMatrixEntryBytesFor(maxDistance), maxDistance, 1);
+
+  _clearAll(m);
+
+  return m;
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeightedSymmetric(
+    unsigned int numVertices) {
+  GraphDistanceMatrix* m =
+      _create(numVertices, numVertices, sizeof(double), 0, 1);
+
+  _clearAll(m);
+
+  return m;
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreate(unsigned int numVertices,
+                                               unsigned int maxDistance) {
+  return GraphDistanceMatrixCreateRows(numVertices, numVertices, maxDistance);
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeighted(
+    unsigned int numVertices) {
+  return GraphDistanceMatrixCreateWeightedRows(numVertices, numVertices);
+}
+
+GraphDistanceMatrix* GraphDistanceMatrixMapFile(int fd,
+                                                unsigned int numVertices,
+                                                unsigned int entryBytes,
+                                                unsigned int maxDistance) {
+  assert(fd >= 0);
+  assert(entryBytes == 1 || entryBytes == 2 || entryBytes == 4 ||
+         entryBytes == sizeof(double));
+
+  GraphDistanceMatrix* m =
+      _alloc(numVertices, numVertices, entryBytes, maxDistance, 0);
+
+  // The rows written may end before the rounded-up size
+  if (ftruncate(fd, (off_t)m->numBytes) != 0) {
+    free(m);
+    return NULL;
+  }
+  void* mapping = mmap(NULL, m->numBytes, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    free(m);
+    return NULL;
+  }
+  m->data = (unsigned char*)mapping;
+  m->isMapped = 1;
+
+  return m;
+}
+
+void GraphDistanceMatrixDestroy(GraphDistanceMatrix** p) {
+  assert(*p != NULL);
+
+  GraphDistanceMatrix* m = *p;
+  if (m->isMapped) {
+    munmap(m->data, m->numBytes);
+  } else {
+    free(m->data);
+  }
+
+  free(*p);
+  *p = NULL;
+}
+
+int GraphDistanceMatrixIsWeighted(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->entryBytes == sizeof(double);
+}
+
+unsigned int GraphDistanceMatrixGetNumVertices(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->numVertices;
+}
+
+int GraphDistanceMatrixIsMapped(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->isMapped;
+}
+
+int GraphDistanceMatrixIsSymmetric(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->isSymmetric;
+}
+
+unsigned int GraphDistanceMatrixGetNumRows(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->numRows;
+}
+
+unsigned int GraphDistanceMatrixGetFirstRow(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->firstRow;
+}
+
+void GraphDistanceMatrixSetFirstRow(GraphDistanceMatrix* m,
+                                    unsigned int firstRow) {
+  assert(m != NULL);
+  assert(!m->isMapped && !m->isSymmetric);
+  m->firstRow = firstRow;
+}
+
+unsigned int GraphDistanceMatrixGetMaxDistance(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->maxDistance;
+}
+
+unsigned int GraphDistanceMatrixGetEntryBytes(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->entryBytes;
+}
+
+size_t GraphDistanceMatrixGetMemoryBytes(const GraphDistanceMatrix* m) {
+  assert(m != NULL);
+  return m->numBytes;
+}
+
+int GraphDistanceMatrixGet(const GraphDistanceMatrix* m, unsigned int v,
+                           unsigned int w) {
+  assert(m != NULL);
+  assert(!GraphDistanceMatrixIsWeighted(m));
+
+  size_t i = _index(m, v, w);
+  switch (m->entryBytes) {
+    case 1: {
+      uint8_t d = m->data[i];
+      return d == UINT8_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+    }
+    case 2: {
+      uint16_t d = ((const uint16_t*)m->data)[i];
+      return d == UINT16_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+    }
+    default: {
+      uint32_t d = ((const uint32_t*)m->data)[i];
+      return d == UINT32_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+    }
+  }
+}
+
+void GraphDistanceMatrixSet(GraphDistanceMatrix* m, unsigned int v,
+                            unsigned int w, int distance) {
+  assert(m != NULL);
+  assert(!m->isMapped);
+  assert(!GraphDistanceMatrixIsWeighted(m));
+  assert(distance == GRAPH_DISTANCE_UNREACHABLE ||
+         (distance >= 0 && (unsigned int)distance <= m->maxDistance));
+
+  // The unreachable value, -1, converts to the all-ones pattern
+  size_t i = _index(m, v, w);
+  switch (m->entryBytes) {
+    case 1:
+      m->data[i] = (uint8_t)distance;
+      break;
+    case 2:
+      ((uint16_t*)m->data)[i] = (uint16_t)distance;
+      break;
+    default:
+      ((uint32_t*)m->data)[i] = (uint32_t)distance;
+      break;
+  }
+}
+
+double GraphDistanceMatrixGetWeighted(const GraphDistanceMatrix* m,
+                                      unsigned int v, unsigned int w) {
+  assert(m != NULL);
+
+  if (!GraphDistanceMatrixIsWeighted(m)) {
+    int d = GraphDistanceMatrixGet(m, v, w);
+    return d == GRAPH_DISTANCE_UNREACHABLE ? INFINITY : (double)d;
+  }
+  return ((const double*)m->data)[_index(m, v, w)];
+}
+
+void GraphDistanceMatrixGetEntries(const GraphDistanceMatrix* m,
+                                   const unsigned int* rows,
+                                   const unsigned int* columns,
+                                   unsigned int count, int* distances) {
+  assert(m != NULL);
+  assert(!GraphDistanceMatrixIsWeighted(m));
+
+  switch (m->entryBytes) {
+    case 1:
+      for (unsigned int i = 0; i < count; i++) {
+        uint8_t d = m->data[_index(m, rows[i], columns[i])];
+        distances[i] = d == UINT8_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+      }
+      break;
+    case 2:
+      for (unsigned int i = 0; i < count; i++) {
+        uint16_t d = ((const uint16_t*)m->data)[_index(m, rows[i], columns[i])];
+        distances[i] = d == UINT16_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+      }
+      break;
+    default:
+      for (unsigned int i = 0; i < count; i++) {
+        uint32_t d = ((const uint32_t*)m->data)[_index(m, rows[i], columns[i])];
+        distances[i] = d == UINT32_MAX ? GRAPH_DISTANCE_UNREACHABLE : (int)d;
+      }
+      break;
+  }
+}
+
+void GraphDistanceMatrixGetWeightedEntries(const GraphDistanceMatrix* m,
+                                           const unsigned int* rows,
+                                           const unsigned int* columns,
+                                           unsigned int count,
+                                           double* distances) {
+  assert(m != NULL);
+
+  if (!GraphDistanceMatrixIsWeighted(m)) {
+    for (unsigned int i = 0; i < count; i++) {
+      distances[i] = GraphDistanceMatrixGetWeighted(m, rows[i], columns[i]);
+    }
+    return;
+  }
+
+  const double* data = (const double*)m->data;
+  for (unsigned int i = 0; i < count; i++) {
+    distances[i] = data[_index(m, rows[i], columns[i])];
+  }
+}
+
+void GraphDistanceMatrixSetWeighted(GraphDistanceMatrix* m, unsigned int v,
+                                    unsigned int w, double distance) {
+  assert(m != NULL);
+  assert(!m->isMapped);
+  assert(GraphDistanceMatrixIsWeighted(m));
+
+  ((double*)m->data)[_index(m, v, w)] = distance;
+}
+
+void GraphDistanceMatrixClearRow(GraphDistanceMatrix* m, unsigned int v) {
+  assert(m != NULL);
+  assert(!m->isMapped && !m->isSymmetric);
+  assert(v >= m->firstRow && v - m->firstRow < m->numRows);
+
+  size_t i = (size_t)(v - m->firstRow) * m->numVertices;
+  if (GraphDistanceMatrixIsWeighted(m)) {
+    double* row = (double*)m->data + i;
+    for (unsigned int w = 0; w < m->numVertices; w++) {
+      row[w] = INFINITY;
+    }
+    return;
+  }
+
+  memset(m->data + i * m->entryBytes, 0xFF,
+         (size_t)m->numVertices * m->entryBytes);
+}
+
+int GraphDistanceMatrixWriteRows(const GraphDistanceMatrix* m, int fd) {
+  assert(m != NULL);
+  assert(!m->isSymmetric);
+  assert(fd >= 0);
+
+  size_t rowBytes = (size_t)m->numVertices * m->entryBytes;
+  const unsigned char* rows = m->data;
+  size_t numBytes = m->numRows * rowBytes;
+  off_t offset = (off_t)(m->firstRow * rowBytes);
+  // pwrite may write fewer bytes than asked
+  while (numBytes > 0) {
+    ssize_t written = pwrite(fd, rows, numBytes, offset);
+    if (written <= 0) return 0;
+    rows += written;
+    numBytes -= (size_t)written;
+    offset += written;
+  }
+  return 1;
+}
@@ -0,0 +1,156 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceMatrix - Dense matrix of integer distances between vertices
+//
+// A single row-major allocation, aligned to a cache line, instead of one
+// allocation per row.
+// Each entry takes 1, 2 or 4 bytes: the narrowest unsigned width that
+// holds every distance up to the bound given at creation, plus the
+// all-ones pattern, which is reserved for "unreachable".
+// For hop distances, 1 byte suffices while the diameter is below 255.
+// For weighted graphs, the entries are doubles, with INFINITY for
+// "unreachable".
+// A matrix may also keep only some rows, e.g., for a cache: row i then
+// holds the distances from some vertex to all the others.
+// Or a window of consecutive rows, which can be moved along a larger
+// matrix, and written to its place in a file: rows of a matrix too large
+// for memory are computed one window at a time, and the file is then
+// mapped, read-only, as the whole matrix. The file holds just the entries,
+// in the same layout.
+// For undirected graphs, a symmetric matrix keeps only the upper triangle,
+// (v, w) with v <= w, packed row by row: half the memory. Entry (w, v) is
+// then entry (v, w), for both reading and writing.
+//
+
+#ifndef _GRAPH_DISTANCE_MATRIX_
+#define _GRAPH_DISTANCE_MATRIX_
+
+#include <stddef.h>
+
+// The value returned for unreachable pairs, whatever the entry width
+#define GRAPH_DISTANCE_UNREACHABLE (-1)
+
+typedef struct _GraphDistanceMatrix GraphDistanceMatrix;
+
+//
+// maxDistance: upper bound on every distance that will be stored
+// All the entries start as unreachable
+//
+GraphDistanceMatrix* GraphDistanceMatrixCreate(unsigned int numVertices,
+                                               unsigned int maxDistance);
+
+// Entries of 8 bytes, holding any double distance
+// All the entries start as unreachable
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeighted(
+    unsigned int numVertices);
+
+// numRows rows of numVertices entries
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateRows(unsigned int numRows,
+                                                   unsigned int numVertices,
+                                                   unsigned int maxDistance);
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeightedRows(
+    unsigned int numRows, unsigned int numVertices);
+
+// Symmetric: V (V + 1) / 2 entries; rows cannot be cleared, moved, nor
+// written to a file
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateSymmetric(
+    unsigned int numVertices, unsigned int maxDistance);
+
+GraphDistanceMatrix* GraphDistanceMatrixCreateWeightedSymmetric(
+    unsigned int numVertices);
+
+// The entry width that GraphDistanceMatrixCreate chooses for maxDistance
+unsigned int GraphDistanceMatrixEntryBytesFor(unsigned int maxDistance);
+
+void GraphDistanceMatrixDestroy(GraphDistanceMatrix** p);
+
+int GraphDistanceMatrixIsWeighted(const GraphDistanceMatrix* m);
+
+unsigned int GraphDistanceMatrixGetNumVertices(const GraphDistanceMatrix* m);
+
+int GraphDistanceMatrixIsSymmetric(const GraphDistanceMatrix* m);
+
+// 1: the matrix is a read-only file mapping (GraphDistanceMatrixMapFile)
+int GraphDistanceMatrixIsMapped(const GraphDistanceMatrix* m);
+
+unsigned int GraphDistanceMatrixGetNumRows(const GraphDistanceMatrix* m);
+
+//
+// The matrix holds rows firstRow .. firstRow+numRows-1 (default: 0 ..)
+// Moving the window keeps the entries: clear the rows for new ones
+//
+unsigned int GraphDistanceMatrixGetFirstRow(const GraphDistanceMatrix* m);
+
+void GraphDistanceMatrixSetFirstRow(GraphDistanceMatrix* m,
+                                    unsigned int firstRow);
+
+// The bound given at creation; 0 if weighted
+unsigned int GraphDistanceMatrixGetMaxDistance(const GraphDistanceMatrix* m);
+
+// 1, 2 or 4; 8 if weighted
+unsigned int GraphDistanceMatrixGetEntryBytes(const GraphDistanceMatrix* m);
+
+size_t GraphDistanceMatrixGetMemoryBytes(const GraphDistanceMatrix* m);
+
+// Entries (v, w): row v, column w
+// Integer matrices only
+// Returns GRAPH_DISTANCE_UNREACHABLE if w is not reachable from v
+int GraphDistanceMatrixGet(const GraphDistanceMatrix* m, unsigned int v,
+                           unsigned int w);
+
+// 0 <= distance <= maxDistance, or GRAPH_DISTANCE_UNREACHABLE
+void GraphDistanceMatrixSet(GraphDistanceMatrix* m, unsigned int v,
+                            unsigned int w, int distance);
+
+// Either kind of matrix
+// Returns INFINITY if w is not reachable from v
+double GraphDistanceMatrixGetWeighted(const GraphDistanceMatrix* m,
+                                      unsigned int v, unsigned int w);
+
+// Several entries: distances[i] is entry (rows[i], columns[i])
+// Read in a loop, without a call per entry: for batches of queries
+void GraphDistanceMatrixGetEntries(const GraphDistanceMatrix* m,
+                                   const unsigned int* rows,
+                                   const unsigned int* columns,
+                                   unsigned int count, int* distances);
+
+void GraphDistanceMatrixGetWeightedEntries(const GraphDistanceMatrix* m,
+                                           const unsigned int* rows,
+                                           const unsigned int* columns,
+                                           unsigned int count,
+                                           double* distances);
+
+// Weighted matrices only; INFINITY: unreachable
+void GraphDistanceMatrixSetWeighted(GraphDistanceMatrix* m, unsigned int v,
+                                    unsigned int w, double distance);
+
+// Every entry of row v becomes unreachable
+void GraphDistanceMatrixClearRow(GraphDistanceMatrix* m, unsigned int v);
+
+// Files
+
+//
+// Writes the rows to their place in the file of a full matrix
+// Returns 0 if the write fails
+//
+int GraphDistanceMatrixWriteRows(const GraphDistanceMatrix* m, int fd);
+
+//
+// The full matrix in the file, mapped read-only: the pages are read on
+// demand, and the kernel may drop them again, so only the pages in use
+// take memory
+// entryBytes: as given by GraphDistanceMatrixEntryBytesFor(maxDistance),
+// or sizeof(double) for a weighted matrix
+// Rows not written read as zeros
+// Returns NULL if the file cannot be mapped; fd may be closed afterwards
+//
+GraphDistanceMatrix* GraphDistanceMatrixMapFile(int fd,
+                                                unsigned int numVertices,
+                                                unsigned int entryBytes,
+                                                unsigned int maxDistance);
+
+#endif  // _GRAPH_DISTANCE_MATRIX_
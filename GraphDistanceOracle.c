@@ -0,0 +1,282 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceOracle - Approximate distances, through landmarks
+//
+
+#include "GraphDistanceOracle.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphBellmanFordAlg.h"
+#include "GraphCSR.h"
+#include "GraphJohnson.h"
+
+struct _GraphDistanceOracle {
+  unsigned int numVertices;
+  unsigned int numLandmarks;
+  unsigned int* landmarks;
+  // Entry v * numLandmarks + i: from landmark i to v, and from v to
+  // landmark i; the same array, for an undirected graph
+  double* fromLandmark;
+  double* toLandmark;
+  double minDistance;  // Lower bound on any distance between two distinct
+                       // vertices: 1 (unweighted), 0 (no negative weights)
+                       // or -INFINITY
+};
+
+// xorshift64*: the random choices depend only on the seed
+static unsigned int _nextRandom(uint64_t* state, unsigned int bound) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (unsigned int)((*state * 0x2545F4914F6CDD1DULL) >> 32) % bound;
+}
+
+static double _minWeight(const Graph* g) {
+  double minWeight = INFINITY;
+  for (unsigned int v = 0; v < GraphGetNumVertices(g); v++) {
+    double* weights = GraphGetDistancesToAdjacents(g, v);
+    for (unsigned int i = 1; i <= (unsigned int)weights[0]; i++) {
+      if (weights[i] < minWeight) minWeight = weights[i];
+    }
+    free(weights);
+  }
+  return minWeight;
+}
+
+// Vertex with the highest degree not yet chosen
+static unsigned int _highestDegree(Graph* g, const int* isLandmark) {
+  unsigned int best = 0;
+  unsigned int bestDegree = 0;
+  int found = 0;
+  for (unsigned int v = 0; v < GraphGetNumVertices(g); v++) {
+    if (isLandmark[v]) continue;
+    unsigned int degree =
+        GraphIsDigraph(g)
+            ? GraphGetVertexOutDegree(g, v) + GraphGetVertexInDegree(g, v)
+            : GraphGetVertexDegree(g, v);
+    if (!found || degree > bestDegree) {
+      best = v;
+      bestDegree = degree;
+      found = 1;
+    }
+  }
+  return best;
+}
+
+// Vertex farthest from the landmarks chosen, i.e., with the largest
+// distance to its closest landmark; unreachable vertices first
+static unsigned int _farthest(const double* closest, const int* isLandmark,
+                              unsigned int numVertices) {
+  unsigned int best = 0;
+  int found = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    if (isLandmark[v]) continue;
+    if (!found || closest[v] > closest[best]) {
+      best = v;
+      found = 1;
+    }
+  }
+  return best;
+}
+
+// Copies the distances of a run into column i of table
+static void _storeDistances(const GraphBellmanFordAlg* run, double* table,
+                            unsigned int i, unsigned int numVertices,
+                            unsigned int numLandmarks) {
+  for (unsigned int v = 0; v < numVertices; v++) {
+    table[(size_t)v * numLandmarks + i] =
+        GraphBellmanFordAlgWeightedDistance(run, v);
+  }
+}
+
+GraphDistanceOracle* GraphDistanceOracleCreate(
+    Graph* g, unsigned int numLandmarks,
+    GraphDistanceOracleLandmarks strategy, unsigned int seed) {
+  assert(g != NULL);
+  assert(numLandmarks <= GraphGetNumVertices(g));
+
+  unsigned int numVertices = GraphGetNumVertices(g);
+  double minWeight = GraphIsWeighted(g) ? _minWeight(g) : 1.0;
+
+  // A negative cycle makes some distances meaningless, even when no
+  // landmark reaches it: one Bellman-Ford run from a virtual source, joined
+  // to every vertex, finds it
+  GraphCSR* csr = GraphCSRCreate(g);
+  if (minWeight < 0.0) {
+    GraphJohnson* johnson = GraphJohnsonCreate(csr);
+    if (johnson == NULL) {
+      GraphCSRDestroy(&csr);
+      return NULL;
+    }
+    GraphJohnsonDestroy(&johnson);
+  }
+
+  GraphDistanceOracle* o =
+      (GraphDistanceOracle*)malloc(sizeof(struct _GraphDistanceOracle));
+  if (o == NULL) abort();
+
+  o->numVertices = numVertices;
+  o->numLandmarks = numLandmarks;
+  // Avoid malloc(0) for oracles without landmarks
+  size_t tableSize = (size_t)numVertices * numLandmarks + 1;
+  o->landmarks =
+      (unsigned int*)malloc((numLandmarks + 1) * sizeof(unsigned int));
+  o->fromLandmark = (double*)malloc(tableSize * sizeof(double));
+  o->toLandmark = GraphIsDigraph(g)
+                      ? (double*)malloc(tableSize * sizeof(double))
+                      : o->fromLandmark;
+  if (o->landmarks == NULL || o->fromLandmark == NULL ||
+      o->toLandmark == NULL) {
+    abort();
+  }
+
+  if (!GraphIsWeighted(g)) {
+    o->minDistance = 1.0;
+  } else {
+    o->minDistance = minWeight >= 0.0 ? 0.0 : -INFINITY;
+  }
+
+  // Backward distances: forward distances on the transpose
+  Graph* transpose = GraphIsDigraph(g) ? GraphCreateTranspose(g) : NULL;
+  GraphBellmanFordAlgWorkspace* forward =
+      GraphBellmanFordAlgWorkspaceCreateShared(g, csr);
+  GraphBellmanFordAlgWorkspace* backward =
+      transpose != NULL ? GraphBellmanFordAlgWorkspaceCreate(transpose) : NULL;
+
+  GraphBellmanFordAlgOptions options = GraphBellmanFordAlgDefaultOptions();
+  options.trackPredecessors = 0;
+
+  int* isLandmark = (int*)calloc(numVertices + 1, sizeof(int));
+  double* closest = (double*)malloc((numVertices + 1) * sizeof(double));
+  if (isLandmark == NULL || closest == NULL) abort();
+  for (unsigned int v = 0; v < numVertices; v++) {
+    closest[v] = INFINITY;
+  }
+  uint64_t state = ((uint64_t)seed << 1) | 1;
+
+  for (unsigned int i = 0; i < numLandmarks; i++) {
+    unsigned int landmark;
+    if (strategy == GRAPH_ORACLE_LANDMARKS_DEGREE) {
+      landmark = _highestDegree(g, isLandmark);
+    } else if (strategy == GRAPH_ORACLE_LANDMARKS_FARTHEST && i > 0) {
+      landmark = _farthest(closest, isLandmark, numVertices);
+    } else {
+      // Uniformly among the vertices not yet chosen
+      unsigned int rank = _nextRandom(&state, numVertices - i);
+      for (landmark = 0; isLandmark[landmark] || rank > 0; landmark++) {
+        if (!isLandmark[landmark]) rank--;
+      }
+    }
+    isLandmark[landmark] = 1;
+    o->landmarks[i] = landmark;
+
+    const GraphBellmanFordAlg* run =
+        GraphBellmanFordAlgExecuteInWorkspace(forward, landmark, &options);
+    assert(run != NULL);
+    _storeDistances(run, o->fromLandmark, i, numVertices, numLandmarks);
+    for (unsigned int v = 0; v < numVertices; v++) {
+      double d = o->fromLandmark[(size_t)v * numLandmarks + i];
+      if (d < closest[v]) closest[v] = d;
+    }
+
+    if (backward != NULL) {
+      run = GraphBellmanFordAlgExecuteInWorkspace(backward, landmark, &options);
+      assert(run != NULL);
+      _storeDistances(run, o->toLandmark, i, numVertices, numLandmarks);
+    }
+  }
+
+  free(closest);
+  free(isLandmark);
+  GraphBellmanFordAlgWorkspaceDestroy(&forward);
+  if (backward != NULL) GraphBellmanFordAlgWorkspaceDestroy(&backward);
+  if (transpose != NULL) GraphDestroy(&transpose);
+  GraphCSRDestroy(&csr);
+
+  return o;
+}
+
+void GraphDistanceOracleDestroy(GraphDistanceOracle** p) {
+  assert(*p != NULL);
+
+  GraphDistanceOracle* o = *p;
+  if (o->toLandmark != o->fromLandmark) free(o->toLandmark);
+  free(o->fromLandmark);
+  free(o->landmarks);
+
+  free(*p);
+  *p = NULL;
+}
+
+unsigned int GraphDistanceOracleGetNumLandmarks(const GraphDistanceOracle* o) {
+  assert(o != NULL);
+  return o->numLandmarks;
+}
+
+unsigned int GraphDistanceOracleGetLandmark(const GraphDistanceOracle* o,
+                                            unsigned int i) {
+  assert(o != NULL);
+  assert(i < o->numLandmarks);
+  return o->landmarks[i];
+}
+
+size_t GraphDistanceOracleGetMemoryBytes(const GraphDistanceOracle* o) {
+  assert(o != NULL);
+
+  size_t tableBytes = (size_t)o->numVertices * o->numLandmarks * sizeof(double);
+  size_t bytes = o->numLandmarks * sizeof(unsigned int) + tableBytes;
+  if (o->toLandmark != o->fromLandmark) bytes += tableBytes;
+  return bytes;
+}
+
+GraphDistanceOracleBounds GraphDistanceOracleQuery(
+    const GraphDistanceOracle* o, unsigned int v, unsigned int w) {
+  assert(o != NULL);
+  assert(v < o->numVertices && w < o->numVertices);
+
+  GraphDistanceOracleBounds bounds;
+  if (v == w) {
+    bounds.lower = bounds.upper = 0.0;
+    return bounds;
+  }
+
+  unsigned int k = o->numLandmarks;
+  const double* fromV = o->fromLandmark + (size_t)v * k;
+  const double* fromW = o->fromLandmark + (size_t)w * k;
+  const double* toV = o->toLandmark + (size_t)v * k;
+  const double* toW = o->toLandmark + (size_t)w * k;
+
+  bounds.lower = o->minDistance;
+  bounds.upper = INFINITY;
+  for (unsigned int i = 0; i < k; i++) {
+    // Through the landmark
+    double path = toV[i] + fromW[i];
+    if (path < bounds.upper) bounds.upper = path;
+
+    // If the landmark reaches v, but not w, then v does not reach w;
+    // likewise, if w reaches the landmark, but v does not
+    if ((fromV[i] != INFINITY && fromW[i] == INFINITY) ||
+        (toW[i] != INFINITY && toV[i] == INFINITY)) {
+      bounds.lower = bounds.upper = INFINITY;
+      return bounds;
+    }
+
+    if (fromV[i] != INFINITY && fromW[i] - fromV[i] > bounds.lower) {
+      bounds.lower = fromW[i] - fromV[i];
+    }
+    if (toW[i] != INFINITY && toV[i] - toW[i] > bounds.lower) {
+      bounds.lower = toV[i] - toW[i];
+    }
+  }
+
+  // Rounding errors could cross the bounds
+  if (bounds.lower > bounds.upper) bounds.lower = bounds.upper;
+
+  return bounds;
+}
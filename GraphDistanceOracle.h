@@ -0,0 +1,71 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceOracle - Approximate distances, through landmarks
+//
+// k landmark vertices are chosen, and the distances from each landmark to
+// every vertex (forward) and from every vertex to each landmark (backward,
+// on the transpose) are computed with Bellman-Ford: O(k V) memory, instead
+// of the O(V^2) of the full matrix.
+// By the triangle inequality, for every landmark L:
+//   d(v, w) <= d(v, L) + d(L, w)
+//   d(v, w) >= d(L, w) - d(L, v)  and  d(v, w) >= d(v, L) - d(w, L)
+// so each query bounds d(v, w) in O(k). The bounds are exact when v or w
+// is a landmark, and get tighter with more, and better spread, landmarks.
+// The distances of each vertex to all landmarks are stored together, so
+// that a query reads four short contiguous arrays.
+// Queries only read the oracle: they may run concurrently.
+//
+
+#ifndef _GRAPH_DISTANCE_ORACLE_
+#define _GRAPH_DISTANCE_ORACLE_
+
+#include <stddef.h>
+
+#include "Graph.h"
+
+typedef struct _GraphDistanceOracle GraphDistanceOracle;
+
+// How the landmarks are chosen
+
+typedef enum {
+  GRAPH_ORACLE_LANDMARKS_RANDOM,    // Uniformly, from the seed
+  GRAPH_ORACLE_LANDMARKS_DEGREE,    // Highest degree (in + out) first
+  GRAPH_ORACLE_LANDMARKS_FARTHEST   // Each landmark is the vertex farthest
+                                    // from the previous ones (unreachable
+                                    // vertices first); the first is random
+} GraphDistanceOracleLandmarks;
+
+// The distance is in [lower, upper]; upper is the length of an actual path
+// INFINITY, in both, if w is not reachable from v; an upper bound of
+// INFINITY with a finite lower bound means no landmark joins v to w
+
+typedef struct {
+  double lower;
+  double upper;
+} GraphDistanceOracleBounds;
+
+//
+// numLandmarks: at most the number of vertices
+// seed: for the random choices
+// Returns NULL if the graph has a negative cycle, anywhere
+//
+GraphDistanceOracle* GraphDistanceOracleCreate(
+    Graph* g, unsigned int numLandmarks,
+    GraphDistanceOracleLandmarks strategy, unsigned int seed);
+
+void GraphDistanceOracleDestroy(GraphDistanceOracle** p);
+
+unsigned int GraphDistanceOracleGetNumLandmarks(const GraphDistanceOracle* o);
+
+// The i-th landmark, in the order chosen
+unsigned int GraphDistanceOracleGetLandmark(const GraphDistanceOracle* o,
+                                            unsigned int i);
+
+size_t GraphDistanceOracleGetMemoryBytes(const GraphDistanceOracle* o);
+
+// O(number of landmarks)
+GraphDistanceOracleBounds GraphDistanceOracleQuery(
+    const GraphDistanceOracle* o, unsigned int v, unsigned int w);
+
+#endif  // _GRAPH_DISTANCE_ORACLE_
@@ -0,0 +1,167 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceRowCache - Bounded cache of rows of a distance matrix
+//
+
+#include "GraphDistanceRowCache.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "GraphDistanceMatrix.h"
+
+#define NONE (-1)
+
+struct _GraphDistanceRowCache {
+  unsigned int numVertices;
+  GraphDistanceMatrix* rows;
+  unsigned int maxRows;
+  unsigned int numRows;  // Rows 0 .. numRows-1 are in use
+  int* rowOf;            // rowOf[v]: the row holding v, or NONE
+  unsigned int* sourceOf;  // sourceOf[row]: the vertex held by row
+  int* newer;            // The LRU list, from the most recent row (head)
+  int* older;            // to the least recent one (tail)
+  int head;
+  int tail;
+  GraphDistanceRowFill fill;
+  void* context;
+  GraphDistanceRowCacheStats stats;
+};
+
+GraphDistanceRowCache* GraphDistanceRowCacheCreate(
+    unsigned int numVertices, int weighted, unsigned int maxDistance,
+    size_t maxBytes, GraphDistanceRowFill fill, void* context) {
+  assert(fill != NULL);
+
+  GraphDistanceRowCache* c =
+      (GraphDistanceRowCache*)malloc(sizeof(struct _GraphDistanceRowCache));
+  if (c == NULL) abort();
+
+  size_t entryBytes = weighted ? sizeof(double)
+                               : GraphDistanceMatrixEntryBytesFor(maxDistance);
+  size_t rowBytes = (size_t)numVertices * entryBytes;
+  size_t maxRows = rowBytes > 0 ? maxBytes / rowBytes : 1;
+  if (maxRows > numVertices) maxRows = numVertices;
+  if (maxRows == 0) maxRows = 1;
+
+  c->numVertices = numVertices;
+  c->maxRows = (unsigned int)maxRows;
+  c->rows = weighted
+                ? GraphDistanceMatrixCreateWeightedRows(c->maxRows, numVertices)
+                : GraphDistanceMatrixCreateRows(c->maxRows, numVertices,
+                                                maxDistance);
+  c->numRows = 0;
+  c->rowOf = (int*)malloc((numVertices + 1) * sizeof(int));
+  c->sourceOf = (unsigned int*)malloc(c->maxRows * sizeof(unsigned int));
+  c->newer = (int*)malloc(c->maxRows * sizeof(int));
+  c->older = (int*)malloc(c->maxRows * sizeof(int));
+  if (c->rowOf == NULL || c->sourceOf == NULL || c->newer == NULL ||
+      c->older == NULL) {
+    abort();
+  }
+  for (unsigned int v = 0; v < numVertices; v++) {
+    c->rowOf[v] = NONE;
+  }
+  c->head = NONE;
+  c->tail = NONE;
+  c->fill = fill;
+  c->context = context;
+
+  c->stats.hits = 0;
+  c->stats.misses = 0;
+  c->stats.evictions = 0;
+  c->stats.numRows = 0;
+  c->stats.maxRows = c->maxRows;
+  c->stats.memoryBytes = GraphDistanceMatrixGetMemoryBytes(c->rows);
+
+  return c;
+}
+
+void GraphDistanceRowCacheDestroy(GraphDistanceRowCache** p) {
+  assert(*p != NULL);
+
+  GraphDistanceRowCache* c = *p;
+  GraphDistanceMatrixDestroy(&c->rows);
+  free(c->rowOf);
+  free(c->sourceOf);
+  free(c->newer);
+  free(c->older);
+
+  free(*p);
+  *p = NULL;
+}
+
+// The LRU list
+
+static void _unlink(GraphDistanceRowCache* c, int row) {
+  if (c->newer[row] != NONE) {
+    c->older[c->newer[row]] = c->older[row];
+  } else {
+    c->head = c->older[row];
+  }
+  if (c->older[row] != NONE) {
+    c->newer[c->older[row]] = c->newer[row];
+  } else {
+    c->tail = c->newer[row];
+  }
+}
+
+static void _pushHead(GraphDistanceRowCache* c, int row) {
+  c->newer[row] = NONE;
+  c->older[row] = c->head;
+  if (c->head != NONE) {
+    c->newer[c->head] = row;
+  } else {
+    c->tail = row;
+  }
+  c->head = row;
+}
+
+unsigned int GraphDistanceRowCacheLookup(GraphDistanceRowCache* c,
+                                         unsigned int source) {
+  assert(c != NULL);
+  assert(source < c->numVertices);
+
+  int row = c->rowOf[source];
+  if (row != NONE) {
+    c->stats.hits++;
+    if (row != c->head) {
+      _unlink(c, row);
+      _pushHead(c, row);
+    }
+    return (unsigned int)row;
+  }
+
+  c->stats.misses++;
+  if (c->numRows < c->maxRows) {
+    row = (int)c->numRows++;
+    c->stats.numRows = c->numRows;
+  } else {
+    // Evict the least recently used row
+    row = c->tail;
+    _unlink(c, row);
+    c->rowOf[c->sourceOf[row]] = NONE;
+    c->stats.evictions++;
+    GraphDistanceMatrixClearRow(c->rows, (unsigned int)row);
+  }
+
+  c->fill(c->context, source, c->rows, (unsigned int)row);
+  c->rowOf[source] = row;
+  c->sourceOf[row] = source;
+  _pushHead(c, row);
+
+  return (unsigned int)row;
+}
+
+const GraphDistanceMatrix* GraphDistanceRowCacheGetRows(
+    const GraphDistanceRowCache* c) {
+  assert(c != NULL);
+  return c->rows;
+}
+
+GraphDistanceRowCacheStats GraphDistanceRowCacheGetStats(
+    const GraphDistanceRowCache* c) {
+  assert(c != NULL);
+  return c->stats;
+}
@@ -0,0 +1,65 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphDistanceRowCache - Bounded cache of rows of a distance matrix
+//
+// Row v holds the distances from v to every vertex. A row is computed, by
+// a callback, only when it is first looked up; at most a given number of
+// bytes of rows are kept, and, when the cache is full, the least recently
+// used row is evicted (LRU) and its storage reused.
+// Lookups and evictions are O(1): a doubly linked list orders the rows by
+// last use, and each vertex knows the row that holds its distances.
+// Not thread-safe: a lookup may compute and evict rows.
+//
+
+#ifndef _GRAPH_DISTANCE_ROW_CACHE_
+#define _GRAPH_DISTANCE_ROW_CACHE_
+
+#include <stddef.h>
+
+#include "GraphDistanceMatrix.h"
+
+typedef struct _GraphDistanceRowCache GraphDistanceRowCache;
+
+//
+// Writes the distances from source into row `row` of rows, whose entries
+// are all unreachable
+//
+typedef void (*GraphDistanceRowFill)(void* context, unsigned int source,
+                                     GraphDistanceMatrix* rows,
+                                     unsigned int row);
+
+typedef struct {
+  unsigned long hits;
+  unsigned long misses;  // Rows computed
+  unsigned long evictions;
+  unsigned int numRows;  // Rows currently kept
+  unsigned int maxRows;
+  size_t memoryBytes;    // Of the rows
+} GraphDistanceRowCacheStats;
+
+//
+// The rows have the entries of a matrix created with the same arguments
+// (see GraphDistanceMatrix); at least one row is kept, whatever maxBytes
+//
+GraphDistanceRowCache* GraphDistanceRowCacheCreate(
+    unsigned int numVertices, int weighted, unsigned int maxDistance,
+    size_t maxBytes, GraphDistanceRowFill fill, void* context);
+
+void GraphDistanceRowCacheDestroy(GraphDistanceRowCache** p);
+
+//
+// The row of GraphDistanceRowCacheGetRows that holds the distances from
+// source, which becomes the most recently used row
+// Valid until the next lookup
+//
+unsigned int GraphDistanceRowCacheLookup(GraphDistanceRowCache* c,
+                                         unsigned int source);
+
+const GraphDistanceMatrix* GraphDistanceRowCacheGetRows(
+    const GraphDistanceRowCache* c);
+
+GraphDistanceRowCacheStats GraphDistanceRowCacheGetStats(
+    const GraphDistanceRowCache* c);
+
+#endif  // _GRAPH_DISTANCE_ROW_CACHE_
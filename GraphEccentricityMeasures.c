@@ -18,12 +18,17 @@
 #include "GraphEccentricityMeasures.h"
 
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <unistd.h>
 
 #include "Graph.h"
-#include "GraphAllPairsShortestDistances.h"
+#include "GraphCSR.h"
+#include "GraphMultiSourceBFS.h"
 
 struct _GraphEccentricityMeasures {
   unsigned int*
@@ -47,16 +52,84 @@ static void InicializarRaioDiametro(GraphEccentricityMeasures* medidas) {
     medidas->graphDiameter = 0;    // Configura o diâmetro inicial como zero
 }
 
-// Função auxiliar para calcular a maior distância de um vértice a outros
-static int CalcularMaiorDistancia(GraphAllPairsShortestDistances* apsd, unsigned int vertice, unsigned int numVertices) {
-    int maiorDistancia = -1; // Variável para armazenar a maior distância
-    for (unsigned int w = 0; w < numVertices; w++) {
-        int distancia = GraphGetDistanceVW(apsd, vertice, w);
-        if (distancia != -1 && distancia > maiorDistancia) {
-            maiorDistancia = distancia; // Atualiza a maior distância encontrada
+// As excentricidades são calculadas sem a matriz das distâncias: cada BFS
+// só guarda o maior nível que atinge, e a memória é O(V) em vez de O(V^2)
+
+// Visitante da MS-BFS: os níveis são visitados por ordem crescente, e o
+// último nível em que uma origem alcança um vértice novo é a sua
+// excentricidade
+// contexto: as excentricidades das origens do lote
+static void RegistarNivel(void* contexto, unsigned int vertice, unsigned int nivel,
+                          const uint64_t* novasOrigens) {
+    (void)vertice;
+    int* excentricidade = (int*)contexto;
+    for (unsigned int palavra = 0; palavra < GRAPH_MSBFS_WORDS; palavra++) {
+        uint64_t bits = novasOrigens[palavra];
+        while (bits != 0) {
+            unsigned int i = 64 * palavra + (unsigned int)__builtin_ctzll(bits);
+            excentricidade[i] = (int)nivel;
+            bits &= bits - 1;
         }
     }
-    return maiorDistancia;
+}
+
+// Os lotes de origens, distribuídos pelas threads
+typedef struct {
+    const GraphCSR* adjacencias;
+    int* excentricidade;
+    unsigned int numVertices;
+    atomic_uint proximaOrigem;
+} TrabalhoExcentricidades;
+
+// Cada thread tem o seu motor de MS-BFS, e escreve as excentricidades
+// das origens dos lotes que retira
+static void* CalcularLotes(void* argumento) {
+    TrabalhoExcentricidades* trabalho = (TrabalhoExcentricidades*)argumento;
+    GraphMSBFS* bfs = GraphMSBFSCreate(trabalho->adjacencias);
+    unsigned int origens[GRAPH_MSBFS_MAX_SOURCES];
+
+    for (;;) {
+        unsigned int primeira = atomic_fetch_add(&trabalho->proximaOrigem, GRAPH_MSBFS_MAX_SOURCES);
+        if (primeira >= trabalho->numVertices) break;
+        unsigned int numOrigens = trabalho->numVertices - primeira;
+        if (numOrigens > GRAPH_MSBFS_MAX_SOURCES) numOrigens = GRAPH_MSBFS_MAX_SOURCES;
+        for (unsigned int i = 0; i < numOrigens; i++) {
+            origens[i] = primeira + i;
+            trabalho->excentricidade[primeira + i] = 0;
+        }
+        GraphMSBFSRun(bfs, origens, numOrigens, RegistarNivel, trabalho->excentricidade + primeira);
+    }
+
+    GraphMSBFSDestroy(&bfs);
+    return NULL;
+}
+
+// Uma thread por processador, e não mais do que os lotes
+static void CalcularExcentricidades(const GraphCSR* adjacencias, int* excentricidade) {
+    TrabalhoExcentricidades trabalho;
+    trabalho.adjacencias = adjacencias;
+    trabalho.excentricidade = excentricidade;
+    trabalho.numVertices = GraphCSRGetNumVertices(adjacencias);
+    atomic_init(&trabalho.proximaOrigem, 0);
+
+    unsigned int numLotes = (trabalho.numVertices + GRAPH_MSBFS_MAX_SOURCES - 1) / GRAPH_MSBFS_MAX_SOURCES;
+    long processadores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int numThreads = processadores > 1 ? (unsigned int)processadores : 1;
+    if (numThreads > numLotes) numThreads = numLotes;
+    if (numThreads <= 1) {
+        CalcularLotes(&trabalho);
+        return;
+    }
+
+    pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+    if (threads == NULL) abort();
+    for (unsigned int t = 0; t < numThreads; t++) {
+        if (pthread_create(&threads[t], NULL, CalcularLotes, &trabalho) != 0) abort();
+    }
+    for (unsigned int t = 0; t < numThreads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
 }
 
 // Função auxiliar para determinar os vértices centrais
@@ -84,8 +157,9 @@ static unsigned int* DeterminarVerticesCentrais(GraphEccentricityMeasures* medid
 
 // Função principal para calcular medidas de excentricidade em um grafo
 GraphEccentricityMeasures* GraphEccentricityMeasuresCompute(Graph* grafo) {
-    // Verifica se o grafo é válido
+    // Verifica se o grafo é válido: as distâncias são números de arestas
     assert(grafo != NULL);
+    assert(!GraphIsWeighted(grafo));
 
     // Aloca a estrutura que armazenará os resultados
     GraphEccentricityMeasures* medidas = 
@@ -97,28 +171,24 @@ GraphEccentricityMeasures* GraphEccentricityMeasuresCompute(Graph* grafo) {
     // Obtém o número de vértices do grafo
     unsigned int numVertices = GraphGetNumVertices(grafo);
 
-    // Calcula as menores distâncias entre todos os pares de vértices
-    GraphAllPairsShortestDistances* apsd = GraphAllPairsShortestDistancesExecute(grafo);
-    if (apsd == NULL) {
-        free(medidas);
-        return NULL;
-    }
-
     // Aloca memória para armazenar a excentricidade de cada vértice
     medidas->eccentricity = (int*)malloc(numVertices * sizeof(int));
     if (medidas->eccentricity == NULL) {
-        GraphAllPairsShortestDistancesDestroy(&apsd);
         free(medidas);
         return NULL;
     }
 
+    // Uma BFS a partir de cada vértice, em lotes de MS-BFS
+    GraphCSR* adjacencias = GraphCSRCreate(grafo);
+    CalcularExcentricidades(adjacencias, medidas->eccentricity);
+    GraphCSRDestroy(&adjacencias);
+
     // Inicializa o raio e o diâmetro do grafo
     InicializarRaioDiametro(medidas);
 
-    // Calcula a excentricidade de cada vértice e atualiza raio e diâmetro
+    // Atualiza raio e diâmetro
     for (unsigned int v = 0; v < numVertices; v++) {
-        int maiorDistancia = CalcularMaiorDistancia(apsd, v, numVertices);
-        medidas->eccentricity[v] = maiorDistancia;
+        int maiorDistancia = medidas->eccentricity[v];
 
         if (maiorDistancia != -1) { // Ignora vértices inacessíveis
             if (maiorDistancia < medidas->graphRadius) {
@@ -133,15 +203,11 @@ GraphEccentricityMeasures* GraphEccentricityMeasuresCompute(Graph* grafo) {
     // Determina os vértices centrais
     medidas->centralVertices = DeterminarVerticesCentrais(medidas, numVertices);
     if (medidas->centralVertices == NULL) {
-        GraphAllPairsShortestDistancesDestroy(&apsd);
         free(medidas->eccentricity);
         free(medidas);
         return NULL;
     }
 
-    // Libera os recursos da estrutura APSD
-    GraphAllPairsShortestDistancesDestroy(&apsd);
-
     return medidas; // Retorna as medidas calculadas
 }
 
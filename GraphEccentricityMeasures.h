@@ -13,6 +13,11 @@
 
 typedef struct _GraphEccentricityMeasures GraphEccentricityMeasures;
 
+//
+// Unweighted graphs only: one BFS per vertex, in bit-parallel batches, each
+// keeping only its deepest level; O(V) memory, the distance matrix is
+// never built
+//
 GraphEccentricityMeasures* GraphEccentricityMeasuresCompute(Graph* g);
 
 void GraphEccentricityMeasuresDestroy(GraphEccentricityMeasures** p);
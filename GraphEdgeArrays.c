@@ -0,0 +1,238 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphEdgeArrays - Edge list of a graph, as three parallel arrays
+//
+
+#include "GraphEdgeArrays.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "GraphCSR.h"
+
+// The SIMD kernels need GCC-style target attributes and x86-64 intrinsics;
+// elsewhere, only the scalar kernel is compiled
+#if defined(__GNUC__) && defined(__x86_64__)
+#define EDGE_ARRAYS_X86 1
+#include <immintrin.h>
+#else
+#define EDGE_ARRAYS_X86 0
+#endif
+
+struct _GraphEdgeArrays {
+  unsigned int numArcs;
+  unsigned int* sources;  // Arrays of size numArcs
+  unsigned int* targets;  // The indices are read as int by the gathers
+  double* weights;
+  GraphEdgeKernel kernel;
+};
+
+GraphEdgeArrays* GraphEdgeArraysCreate(const GraphCSR* csr) {
+  assert(csr != NULL);
+  assert(GraphCSRGetNumVertices(csr) <= (unsigned int)INT_MAX);
+
+  GraphEdgeArrays* ea =
+      (GraphEdgeArrays*)malloc(sizeof(struct _GraphEdgeArrays));
+  if (ea == NULL) abort();
+
+  unsigned int numVertices = GraphCSRGetNumVertices(csr);
+  unsigned int numArcs = GraphCSRGetNumArcs(csr);
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+  const double* weights = GraphCSRGetWeights(csr);
+
+  ea->numArcs = numArcs;
+  // Avoid malloc(0) for graphs without edges
+  ea->sources = (unsigned int*)malloc((numArcs + 1) * sizeof(unsigned int));
+  ea->targets = (unsigned int*)malloc((numArcs + 1) * sizeof(unsigned int));
+  ea->weights = (double*)malloc((numArcs + 1) * sizeof(double));
+  if (ea->sources == NULL || ea->targets == NULL || ea->weights == NULL)
+    abort();
+
+  for (unsigned int v = 0; v < numVertices; v++) {
+    for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+      ea->sources[k] = v;
+      ea->targets[k] = targets[k];
+      ea->weights[k] = weights != NULL ? weights[k] : 1.0;
+    }
+  }
+
+  ea->kernel = GraphEdgeArraysBestKernel();
+
+  return ea;
+}
+
+void GraphEdgeArraysDestroy(GraphEdgeArrays** p) {
+  assert(*p != NULL);
+
+  GraphEdgeArrays* ea = *p;
+  free(ea->sources);
+  free(ea->targets);
+  free(ea->weights);
+
+  free(*p);
+  *p = NULL;
+}
+
+unsigned int GraphEdgeArraysGetNumArcs(const GraphEdgeArrays* ea) {
+  assert(ea != NULL);
+  return ea->numArcs;
+}
+
+// Kernels
+
+GraphEdgeKernel GraphEdgeArraysBestKernel(void) {
+  if (GraphEdgeArraysKernelIsSupported(GRAPH_EDGE_KERNEL_AVX512)) {
+    return GRAPH_EDGE_KERNEL_AVX512;
+  }
+  if (GraphEdgeArraysKernelIsSupported(GRAPH_EDGE_KERNEL_AVX2)) {
+    return GRAPH_EDGE_KERNEL_AVX2;
+  }
+  return GRAPH_EDGE_KERNEL_SCALAR;
+}
+
+int GraphEdgeArraysKernelIsSupported(GraphEdgeKernel kernel) {
+  switch (kernel) {
+    case GRAPH_EDGE_KERNEL_SCALAR:
+      return 1;
+#if EDGE_ARRAYS_X86
+    case GRAPH_EDGE_KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case GRAPH_EDGE_KERNEL_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return 0;
+  }
+}
+
+const char* GraphEdgeArraysKernelName(GraphEdgeKernel kernel) {
+  switch (kernel) {
+    case GRAPH_EDGE_KERNEL_SCALAR:
+      return "scalar";
+    case GRAPH_EDGE_KERNEL_AVX2:
+      return "AVX2";
+    case GRAPH_EDGE_KERNEL_AVX512:
+      return "AVX-512";
+  }
+  return "unknown";
+}
+
+GraphEdgeKernel GraphEdgeArraysGetKernel(const GraphEdgeArrays* ea) {
+  assert(ea != NULL);
+  return ea->kernel;
+}
+
+void GraphEdgeArraysSetKernel(GraphEdgeArrays* ea, GraphEdgeKernel kernel) {
+  assert(ea != NULL);
+  assert(GraphEdgeArraysKernelIsSupported(kernel));
+  ea->kernel = kernel;
+}
+
+// Write back an improving arc
+// The comparison is repeated: an earlier arc with the same target may
+// already have lowered its distance
+static inline unsigned int _update(const GraphEdgeArrays* ea, unsigned int i,
+                                   double candidate, double* distance,
+                                   int* predecessor, unsigned int* marked,
+                                   unsigned int stamp) {
+  unsigned int v = ea->targets[i];
+  if (!(candidate < distance[v])) return 0;
+  distance[v] = candidate;
+  if (predecessor != NULL) predecessor[v] = (int)ea->sources[i];
+  marked[v] = stamp;
+  return 1;
+}
+
+static unsigned int _relaxScalar(const GraphEdgeArrays* ea, unsigned int first,
+                                 const double* sourceDistance,
+                                 double* distance, int* predecessor,
+                                 unsigned int* marked, unsigned int stamp) {
+  unsigned int updates = 0;
+  for (unsigned int i = first; i < ea->numArcs; i++) {
+    double candidate = sourceDistance[ea->sources[i]] + ea->weights[i];
+    updates += _update(ea, i, candidate, distance, predecessor, marked, stamp);
+  }
+  return updates;
+}
+
+#if EDGE_ARRAYS_X86
+
+__attribute__((target("avx2"))) static unsigned int _relaxAVX2(
+    const GraphEdgeArrays* ea, const double* sourceDistance, double* distance,
+    int* predecessor, unsigned int* marked, unsigned int stamp) {
+  unsigned int updates = 0;
+  unsigned int i = 0;
+  for (; i + 4 <= ea->numArcs; i += 4) {
+    __m128i u = _mm_loadu_si128((const __m128i*)&ea->sources[i]);
+    __m128i v = _mm_loadu_si128((const __m128i*)&ea->targets[i]);
+    __m256d candidate = _mm256_add_pd(_mm256_i32gather_pd(sourceDistance, u, 8),
+                                      _mm256_loadu_pd(&ea->weights[i]));
+    __m256d current = _mm256_i32gather_pd(distance, v, 8);
+    int mask = _mm256_movemask_pd(_mm256_cmp_pd(candidate, current, _CMP_LT_OQ));
+    if (mask == 0) continue;
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, candidate);
+    for (; mask != 0; mask &= mask - 1) {
+      unsigned int lane = (unsigned int)__builtin_ctz((unsigned int)mask);
+      updates += _update(ea, i + lane, lanes[lane], distance, predecessor,
+                         marked, stamp);
+    }
+  }
+  return updates + _relaxScalar(ea, i, sourceDistance, distance, predecessor,
+                                marked, stamp);
+}
+
+__attribute__((target("avx512f"))) static unsigned int _relaxAVX512(
+    const GraphEdgeArrays* ea, const double* sourceDistance, double* distance,
+    int* predecessor, unsigned int* marked, unsigned int stamp) {
+  unsigned int updates = 0;
+  unsigned int i = 0;
+  for (; i + 8 <= ea->numArcs; i += 8) {
+    __m256i u = _mm256_loadu_si256((const __m256i*)&ea->sources[i]);
+    __m256i v = _mm256_loadu_si256((const __m256i*)&ea->targets[i]);
+    __m512d candidate = _mm512_add_pd(_mm512_i32gather_pd(u, sourceDistance, 8),
+                                      _mm512_loadu_pd(&ea->weights[i]));
+    __m512d current = _mm512_i32gather_pd(v, distance, 8);
+    unsigned int mask =
+        (unsigned int)_mm512_cmp_pd_mask(candidate, current, _CMP_LT_OQ);
+    if (mask == 0) continue;
+
+    double lanes[8];
+    _mm512_storeu_pd(lanes, candidate);
+    for (; mask != 0; mask &= mask - 1) {
+      unsigned int lane = (unsigned int)__builtin_ctz(mask);
+      updates += _update(ea, i + lane, lanes[lane], distance, predecessor,
+                         marked, stamp);
+    }
+  }
+  return updates + _relaxScalar(ea, i, sourceDistance, distance, predecessor,
+                                marked, stamp);
+}
+
+#endif  // EDGE_ARRAYS_X86
+
+unsigned int GraphEdgeArraysRelax(const GraphEdgeArrays* ea,
+                                  const double* sourceDistance,
+                                  double* distance, int* predecessor,
+                                  unsigned int* marked, unsigned int stamp) {
+  assert(ea != NULL);
+  assert(sourceDistance != NULL && distance != NULL && marked != NULL);
+
+  switch (ea->kernel) {
+#if EDGE_ARRAYS_X86
+    case GRAPH_EDGE_KERNEL_AVX2:
+      return _relaxAVX2(ea, sourceDistance, distance, predecessor, marked,
+                        stamp);
+    case GRAPH_EDGE_KERNEL_AVX512:
+      return _relaxAVX512(ea, sourceDistance, distance, predecessor, marked,
+                          stamp);
+#endif
+    default:
+      return _relaxScalar(ea, 0, sourceDistance, distance, predecessor, marked,
+                          stamp);
+  }
+}
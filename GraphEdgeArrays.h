@@ -0,0 +1,69 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphEdgeArrays - Edge list of a graph, as three parallel arrays
+//
+// Arc i goes from sources[i] to targets[i], with weight weights[i]
+// (1.0, if the graph is unweighted); the arcs are grouped by source vertex.
+// A relaxation pass scans the arcs in one tight loop, with no per-vertex
+// indirection, which maps onto SIMD gathers:
+// distance[sources[i]] + weights[i] is compared with distance[targets[i]]
+// for 4 (AVX2) or 8 (AVX-512) arcs at a time, and only the improving arcs
+// are written back, one by one, so that arcs with the same target in one
+// vector (conflicts) are resolved correctly.
+// The kernel is chosen at run time, from the features of the CPU.
+//
+
+#ifndef _GRAPH_EDGE_ARRAYS_
+#define _GRAPH_EDGE_ARRAYS_
+
+#include "GraphCSR.h"
+
+typedef struct _GraphEdgeArrays GraphEdgeArrays;
+
+typedef enum {
+  GRAPH_EDGE_KERNEL_SCALAR,
+  GRAPH_EDGE_KERNEL_AVX2,
+  GRAPH_EDGE_KERNEL_AVX512
+} GraphEdgeKernel;
+
+//
+// The arcs of the snapshot; the number of vertices must fit in an int
+// Uses the best kernel supported by the CPU
+//
+GraphEdgeArrays* GraphEdgeArraysCreate(const GraphCSR* csr);
+
+void GraphEdgeArraysDestroy(GraphEdgeArrays** p);
+
+unsigned int GraphEdgeArraysGetNumArcs(const GraphEdgeArrays* ea);
+
+// Kernels
+
+// The best kernel supported by this CPU
+GraphEdgeKernel GraphEdgeArraysBestKernel(void);
+
+int GraphEdgeArraysKernelIsSupported(GraphEdgeKernel kernel);
+
+const char* GraphEdgeArraysKernelName(GraphEdgeKernel kernel);
+
+GraphEdgeKernel GraphEdgeArraysGetKernel(const GraphEdgeArrays* ea);
+
+// The kernel must be supported by this CPU
+void GraphEdgeArraysSetKernel(GraphEdgeArrays* ea, GraphEdgeKernel kernel);
+
+//
+// One relaxation pass over every arc
+// For each arc (u, v): if sourceDistance[u] + weight < distance[v], then
+// distance[v] is updated, predecessor[v] = u (if predecessor != NULL) and
+// marked[v] = stamp
+// Vertices not reached must have distance INFINITY
+// sourceDistance may be distance itself: updates are then seen by the
+// arcs scanned later in the same pass
+// Returns the number of updates
+//
+unsigned int GraphEdgeArraysRelax(const GraphEdgeArrays* ea,
+                                  const double* sourceDistance,
+                                  double* distance, int* predecessor,
+                                  unsigned int* marked, unsigned int stamp);
+
+#endif  // _GRAPH_EDGE_ARRAYS_
@@ -0,0 +1,268 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphFloydWarshall - Blocked Floyd-Warshall, for dense graphs
+//
+
+#include "GraphFloydWarshall.h"
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "GraphCSR.h"
+
+// The AVX2 kernel needs GCC-style target attributes and x86-64 intrinsics;
+// elsewhere, only the scalar kernel is compiled
+#if defined(__GNUC__) && defined(__x86_64__)
+#define FLOYD_WARSHALL_X86 1
+#include <immintrin.h>
+#else
+#define FLOYD_WARSHALL_X86 0
+#endif
+
+// 3 tiles of 32 x 32 doubles fit in a 32 KB L1 data cache
+#define TILE 32
+
+typedef void (*TileKernel)(double* c, const double* a, const double* b,
+                           size_t stride);
+
+struct _GraphFloydWarshall {
+  unsigned int numVertices;
+  unsigned int numTiles;  // Per row of tiles
+  size_t stride;          // numTiles * TILE
+  double* distance;       // stride x stride, row-major
+  TileKernel kernel;
+};
+
+// The tile kernels
+// c[i][j] = min(c[i][j], a[i][k] + b[k][j]), for k = 0 .. TILE-1, in order
+// c may be the same tile as a or b: that is step (1) or (2), and, as in
+// the plain algorithm, the order of k makes the updates in place correct
+
+static void _kernelScalar(double* c, const double* a, const double* b,
+                          size_t stride) {
+  for (unsigned int k = 0; k < TILE; k++) {
+    const double* bk = b + k * stride;
+    for (unsigned int i = 0; i < TILE; i++) {
+      double aik = a[i * stride + k];
+      if (aik == INFINITY) continue;
+      double* ci = c + i * stride;
+      for (unsigned int j = 0; j < TILE; j++) {
+        double sum = aik + bk[j];
+        if (sum < ci[j]) ci[j] = sum;
+      }
+    }
+  }
+}
+
+#if FLOYD_WARSHALL_X86
+__attribute__((target("avx2"))) static void _kernelAVX2(double* c,
+                                                        const double* a,
+                                                        const double* b,
+                                                        size_t stride) {
+  for (unsigned int k = 0; k < TILE; k++) {
+    const double* bk = b + k * stride;
+    for (unsigned int i = 0; i < TILE; i++) {
+      double aik = a[i * stride + k];
+      if (aik == INFINITY) continue;
+      __m256d vaik = _mm256_set1_pd(aik);
+      double* ci = c + i * stride;
+      for (unsigned int j = 0; j < TILE; j += 4) {
+        __m256d sum = _mm256_add_pd(vaik, _mm256_load_pd(bk + j));
+        _mm256_store_pd(ci + j, _mm256_min_pd(_mm256_load_pd(ci + j), sum));
+      }
+    }
+  }
+}
+#endif
+
+GraphFloydWarshallKernel GraphFloydWarshallBestKernel(void) {
+  if (GraphFloydWarshallKernelIsSupported(GRAPH_FLOYD_WARSHALL_KERNEL_AVX2)) {
+    return GRAPH_FLOYD_WARSHALL_KERNEL_AVX2;
+  }
+  return GRAPH_FLOYD_WARSHALL_KERNEL_SCALAR;
+}
+
+int GraphFloydWarshallKernelIsSupported(GraphFloydWarshallKernel kernel) {
+#if FLOYD_WARSHALL_X86
+  __builtin_cpu_init();
+#endif
+  switch (kernel) {
+    case GRAPH_FLOYD_WARSHALL_KERNEL_SCALAR:
+      return 1;
+#if FLOYD_WARSHALL_X86
+    case GRAPH_FLOYD_WARSHALL_KERNEL_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return 0;
+  }
+}
+
+static double* _tile(const GraphFloydWarshall* fw, unsigned int ti,
+                     unsigned int tj) {
+  return fw->distance + (size_t)ti * TILE * fw->stride + (size_t)tj * TILE;
+}
+
+// Work shared by the threads: thread id handles the tiles id,
+// id + numThreads, ... of steps (2) and (3)
+typedef struct {
+  GraphFloydWarshall* fw;
+  unsigned int id;
+  unsigned int numThreads;
+  pthread_barrier_t* barrier;  // NULL for a single thread
+} Worker;
+
+static void _wait(const Worker* w) {
+  if (w->barrier != NULL) pthread_barrier_wait(w->barrier);
+}
+
+static void* _run(void* arg) {
+  const Worker* w = (const Worker*)arg;
+  GraphFloydWarshall* fw = w->fw;
+  TileKernel kernel = fw->kernel;
+  size_t stride = fw->stride;
+
+  for (unsigned int k = 0; k < fw->numTiles; k++) {
+    double* diagonal = _tile(fw, k, k);
+
+    // (1) The diagonal tile
+    if (w->id == 0) kernel(diagonal, diagonal, diagonal, stride);
+    _wait(w);
+
+    // (2) Row k and column k
+    for (unsigned int t = w->id; t < fw->numTiles; t += w->numThreads) {
+      if (t == k) continue;
+      double* row = _tile(fw, k, t);
+      kernel(row, diagonal, row, stride);
+      double* column = _tile(fw, t, k);
+      kernel(column, column, diagonal, stride);
+    }
+    _wait(w);
+
+    // (3) The remaining tiles, one row of tiles at a time
+    for (unsigned int ti = w->id; ti < fw->numTiles; ti += w->numThreads) {
+      if (ti == k) continue;
+      const double* column = _tile(fw, ti, k);
+      for (unsigned int tj = 0; tj < fw->numTiles; tj++) {
+        if (tj == k) continue;
+        kernel(_tile(fw, ti, tj), column, _tile(fw, k, tj), stride);
+      }
+    }
+    _wait(w);
+  }
+  return NULL;
+}
+
+GraphFloydWarshall* GraphFloydWarshallExecute(const GraphCSR* csr,
+                                              unsigned int numThreads) {
+  return GraphFloydWarshallExecuteWithKernel(csr, numThreads,
+                                             GraphFloydWarshallBestKernel());
+}
+
+GraphFloydWarshall* GraphFloydWarshallExecuteWithKernel(
+    const GraphCSR* csr, unsigned int numThreads,
+    GraphFloydWarshallKernel kernel) {
+  assert(csr != NULL);
+  assert(numThreads >= 1);
+  assert(GraphFloydWarshallKernelIsSupported(kernel));
+
+  GraphFloydWarshall* fw =
+      (GraphFloydWarshall*)malloc(sizeof(struct _GraphFloydWarshall));
+  if (fw == NULL) abort();
+
+  unsigned int n = GraphCSRGetNumVertices(csr);
+  fw->numVertices = n;
+  // At least one tile, to avoid a zero-sized allocation
+  fw->numTiles = n / TILE + 1;
+  fw->stride = (size_t)fw->numTiles * TILE;
+  fw->distance = (double*)aligned_alloc(
+      64, fw->stride * fw->stride * sizeof(double));
+  if (fw->distance == NULL) abort();
+
+  fw->kernel = _kernelScalar;
+#if FLOYD_WARSHALL_X86
+  if (kernel == GRAPH_FLOYD_WARSHALL_KERNEL_AVX2) fw->kernel = _kernelAVX2;
+#endif
+
+  // The padding vertices have no arcs: they change no distance
+  for (size_t i = 0; i < fw->stride * fw->stride; i++) {
+    fw->distance[i] = INFINITY;
+  }
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+  const double* weights = GraphCSRGetWeights(csr);
+  for (unsigned int v = 0; v < n; v++) {
+    double* row = fw->distance + v * fw->stride;
+    row[v] = 0.0;
+    for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+      double weight = weights != NULL ? weights[k] : 1.0;
+      if (weight < row[targets[k]]) row[targets[k]] = weight;
+    }
+  }
+
+  if (numThreads > fw->numTiles) numThreads = fw->numTiles;
+  Worker* workers = (Worker*)malloc(numThreads * sizeof(Worker));
+  pthread_t* threads = (pthread_t*)malloc(numThreads * sizeof(pthread_t));
+  if (workers == NULL || threads == NULL) abort();
+  pthread_barrier_t barrier;
+  if (numThreads > 1) pthread_barrier_init(&barrier, NULL, numThreads);
+
+  for (unsigned int t = 0; t < numThreads; t++) {
+    workers[t].fw = fw;
+    workers[t].id = t;
+    workers[t].numThreads = numThreads;
+    workers[t].barrier = numThreads > 1 ? &barrier : NULL;
+  }
+  // The calling thread is worker 0
+  for (unsigned int t = 1; t < numThreads; t++) {
+    if (pthread_create(&threads[t], NULL, _run, &workers[t]) != 0) abort();
+  }
+  _run(&workers[0]);
+  for (unsigned int t = 1; t < numThreads; t++) {
+    pthread_join(threads[t], NULL);
+  }
+
+  if (numThreads > 1) pthread_barrier_destroy(&barrier);
+  free(threads);
+  free(workers);
+
+  return fw;
+}
+
+void GraphFloydWarshallDestroy(GraphFloydWarshall** p) {
+  assert(*p != NULL);
+
+  GraphFloydWarshall* fw = *p;
+  free(fw->distance);
+
+  free(*p);
+  *p = NULL;
+}
+
+int GraphFloydWarshallHasNegativeCycle(const GraphFloydWarshall* fw) {
+  assert(fw != NULL);
+
+  for (unsigned int v = 0; v < fw->numVertices; v++) {
+    if (fw->distance[v * fw->stride + v] < 0.0) return 1;
+  }
+  return 0;
+}
+
+double GraphFloydWarshallGetDistance(const GraphFloydWarshall* fw,
+                                     unsigned int v, unsigned int w) {
+  assert(fw != NULL);
+  assert(v < fw->numVertices && w < fw->numVertices);
+
+  return fw->distance[v * fw->stride + w];
+}
+
+const double* GraphFloydWarshallGetRow(const GraphFloydWarshall* fw,
+                                       unsigned int v) {
+  assert(fw != NULL);
+  assert(v < fw->numVertices);
+
+  return fw->distance + v * fw->stride;
+}
@@ -0,0 +1,65 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphFloydWarshall - Blocked Floyd-Warshall, for dense graphs
+//
+// The distances are kept in a flat matrix of doubles, padded to a multiple
+// of the tile size, and updated tile by tile (Venkataraman et al., 2003):
+// for each diagonal tile k, (1) the diagonal tile itself, (2) the tiles in
+// row k and column k, using the diagonal tile, and (3) every other tile
+// (i, j), with the min-plus product of tiles (i, k) and (k, j).
+// Each step works on a few tiles that stay in cache; the inner loop, over
+// a row of a tile, uses AVX2 if the CPU supports it (or the kernel asked
+// for).
+// The tiles of steps (2) and (3) are independent, and are shared among
+// threads.
+// O(V^3) time and O(V^2) memory, whatever the number of edges; negative
+// weights are allowed.
+//
+
+#ifndef _GRAPH_FLOYD_WARSHALL_
+#define _GRAPH_FLOYD_WARSHALL_
+
+#include "GraphCSR.h"
+
+typedef struct _GraphFloydWarshall GraphFloydWarshall;
+
+typedef enum {
+  GRAPH_FLOYD_WARSHALL_KERNEL_SCALAR,
+  GRAPH_FLOYD_WARSHALL_KERNEL_AVX2
+} GraphFloydWarshallKernel;
+
+// Kernels
+
+// The best kernel supported by this CPU
+GraphFloydWarshallKernel GraphFloydWarshallBestKernel(void);
+
+int GraphFloydWarshallKernelIsSupported(GraphFloydWarshallKernel kernel);
+
+// Computes the distances between all pairs of vertices of the snapshot,
+// with numThreads threads (at least 1)
+// Unweighted graphs: each arc weighs 1
+// Uses the best kernel supported by the CPU
+GraphFloydWarshall* GraphFloydWarshallExecute(const GraphCSR* csr,
+                                              unsigned int numThreads);
+
+// The same, with the given kernel, which must be supported by this CPU
+GraphFloydWarshall* GraphFloydWarshallExecuteWithKernel(
+    const GraphCSR* csr, unsigned int numThreads,
+    GraphFloydWarshallKernel kernel);
+
+void GraphFloydWarshallDestroy(GraphFloydWarshall** p);
+
+// 1 if some vertex lies on a negative cycle: the distances are then
+// meaningless
+int GraphFloydWarshallHasNegativeCycle(const GraphFloydWarshall* fw);
+
+// INFINITY if w is not reachable from v
+double GraphFloydWarshallGetDistance(const GraphFloydWarshall* fw,
+                                     unsigned int v, unsigned int w);
+
+// The distances from v to every vertex
+const double* GraphFloydWarshallGetRow(const GraphFloydWarshall* fw,
+                                       unsigned int v);
+
+#endif  // _GRAPH_FLOYD_WARSHALL_
@@ -0,0 +1,133 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphFrontier - A set of vertices, for level-by-level traversals
+//
+
+#include "GraphFrontier.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct _GraphFrontier {
+  unsigned int numVertices;
+  unsigned int numWords;   // Words of the bitmap
+  uint64_t* bitmap;        // Always valid
+  unsigned int* list;      // The vertices, valid only in the sparse form
+  unsigned int size;       // Number of vertices in the frontier
+  int isDense;
+  unsigned int denseSize;  // Go dense when size > denseSize
+};
+
+GraphFrontier* GraphFrontierCreate(unsigned int numVertices) {
+  GraphFrontier* f = (GraphFrontier*)malloc(sizeof(struct _GraphFrontier));
+  if (f == NULL) abort();
+
+  f->numVertices = numVertices;
+  f->numWords = (numVertices + 63) / 64;
+  // Avoid malloc(0) for graphs without vertices
+  f->bitmap = (uint64_t*)calloc(f->numWords + 1, sizeof(uint64_t));
+  f->list = (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  if (f->bitmap == NULL || f->list == NULL) abort();
+
+  f->size = 0;
+  f->isDense = 0;
+  GraphFrontierSetDenseDivisor(f, 32);
+
+  return f;
+}
+
+void GraphFrontierDestroy(GraphFrontier** p) {
+  assert(*p != NULL);
+
+  GraphFrontier* f = *p;
+  free(f->bitmap);
+  free(f->list);
+
+  free(*p);
+  *p = NULL;
+}
+
+void GraphFrontierClear(GraphFrontier* f) {
+  assert(f != NULL);
+
+  if (f->isDense) {
+    memset(f->bitmap, 0, f->numWords * sizeof(uint64_t));
+  } else {
+    for (unsigned int i = 0; i < f->size; i++) {
+      f->bitmap[f->list[i] / 64] = 0;
+    }
+  }
+  f->size = 0;
+  f->isDense = 0;
+}
+
+int GraphFrontierAdd(GraphFrontier* f, unsigned int v) {
+  assert(f != NULL);
+  assert(v < f->numVertices);
+
+  uint64_t bit = (uint64_t)1 << (v % 64);
+  if (f->bitmap[v / 64] & bit) return 0;
+
+  f->bitmap[v / 64] |= bit;
+  if (!f->isDense) {
+    f->list[f->size] = v;
+    if (f->size + 1 > f->denseSize) f->isDense = 1;
+  }
+  f->size++;
+  return 1;
+}
+
+int GraphFrontierContains(const GraphFrontier* f, unsigned int v) {
+  assert(f != NULL);
+  assert(v < f->numVertices);
+  return (f->bitmap[v / 64] >> (v % 64)) & 1;
+}
+
+unsigned int GraphFrontierSize(const GraphFrontier* f) {
+  assert(f != NULL);
+  return f->size;
+}
+
+int GraphFrontierIsDense(const GraphFrontier* f) {
+  assert(f != NULL);
+  return f->isDense;
+}
+
+void GraphFrontierSetDenseDivisor(GraphFrontier* f, unsigned int divisor) {
+  assert(f != NULL);
+  assert(divisor > 0);
+  f->denseSize = f->numVertices / divisor;
+}
+
+int GraphFrontierNext(const GraphFrontier* f, unsigned int* cursor,
+                      unsigned int* v) {
+  assert(f != NULL);
+
+  if (!f->isDense) {
+    if (*cursor >= f->size) return 0;
+    *v = f->list[(*cursor)++];
+    return 1;
+  }
+
+  // Dense: the cursor is the next vertex index to examine
+  unsigned int word = *cursor / 64;
+  if (word >= f->numWords) return 0;
+  uint64_t bits = f->bitmap[word] & (~(uint64_t)0 << (*cursor % 64));
+  while (bits == 0) {
+    if (++word >= f->numWords) {
+      *cursor = f->numVertices;
+      return 0;
+    }
+    bits = f->bitmap[word];
+  }
+  *v = word * 64 + (unsigned int)__builtin_ctzll(bits);
+  *cursor = *v + 1;
+  return 1;
+}
+
+const uint64_t* GraphFrontierGetBitmap(const GraphFrontier* f) {
+  assert(f != NULL);
+  return f->bitmap;
+}
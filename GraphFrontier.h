@@ -0,0 +1,57 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphFrontier - A set of vertices, for level-by-level traversals
+//
+// A bitmap of the vertices is always kept, so that membership is O(1).
+// While the frontier is small, the vertices are also listed (sparse form):
+// iterating and clearing cost O(size), not O(number of vertices).
+// When the frontier grows past a fraction of the vertices, the list is
+// dropped (dense form): iterating and clearing then scan the bitmap, 64
+// vertices per word, which is cheaper than keeping a huge list.
+// Clearing returns the frontier to the sparse form.
+//
+
+#ifndef _GRAPH_FRONTIER_
+#define _GRAPH_FRONTIER_
+
+#include <stdint.h>
+
+typedef struct _GraphFrontier GraphFrontier;
+
+GraphFrontier* GraphFrontierCreate(unsigned int numVertices);
+
+void GraphFrontierDestroy(GraphFrontier** p);
+
+// O(size) in the sparse form, O(number of vertices / 64) in the dense form
+void GraphFrontierClear(GraphFrontier* f);
+
+// Returns 1 if v was added, 0 if it was already in the frontier
+int GraphFrontierAdd(GraphFrontier* f, unsigned int v);
+
+int GraphFrontierContains(const GraphFrontier* f, unsigned int v);
+
+unsigned int GraphFrontierSize(const GraphFrontier* f);
+
+int GraphFrontierIsDense(const GraphFrontier* f);
+
+//
+// Goes to the dense form when the size exceeds numVertices / divisor
+// (default divisor: 32)
+//
+void GraphFrontierSetDenseDivisor(GraphFrontier* f, unsigned int divisor);
+
+//
+// Iteration, in either form:
+//   unsigned int cursor = 0, v;
+//   while (GraphFrontierNext(f, &cursor, &v)) { ... }
+// Sparse form: in the order of insertion; dense form: by increasing index
+// The frontier must not change during the iteration
+//
+int GraphFrontierNext(const GraphFrontier* f, unsigned int* cursor,
+                      unsigned int* v);
+
+// The bitmap: v is in the frontier iff bit (v % 64) of word (v / 64) is set
+const uint64_t* GraphFrontierGetBitmap(const GraphFrontier* f);
+
+#endif  // _GRAPH_FRONTIER_
@@ -0,0 +1,168 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphJohnson - Johnson's reweighting, for shortest paths from many sources
+//
+
+#include "GraphJohnson.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "GraphCSR.h"
+#include "GraphEdgeArrays.h"
+#include "IndexedMinHeap.h"
+
+struct _GraphJohnson {
+  const GraphCSR* csr;
+  double* potential;  // h(v)
+  double* weight;     // w'(u, v), parallel to the CSR targets
+};
+
+struct _GraphJohnsonSearch {
+  const GraphJohnson* johnson;
+  double* reduced;   // d'(source, v)
+  double* distance;  // d(source, v)
+  MinHeap* heap;
+};
+
+// Bellman-Ford from the virtual source: every potential starts at 0, the
+// weight of its virtual arc. Shortest paths from the virtual source have at
+// most V-1 real arcs, so updates in pass V reveal a negative cycle.
+// Returns 0 on a negative cycle
+static int _computePotentials(GraphJohnson* j) {
+  unsigned int n = GraphCSRGetNumVertices(j->csr);
+  GraphEdgeArrays* arcs = GraphEdgeArraysCreate(j->csr);
+  unsigned int* marked =
+      (unsigned int*)calloc(n + 1, sizeof(unsigned int));
+  if (marked == NULL) abort();
+
+  for (unsigned int v = 0; v < n; v++) {
+    j->potential[v] = 0.0;
+  }
+  unsigned int pass = 0;
+  while (pass < n && GraphEdgeArraysRelax(arcs, j->potential, j->potential,
+                                          NULL, marked, 1) > 0) {
+    pass++;
+  }
+
+  free(marked);
+  GraphEdgeArraysDestroy(&arcs);
+
+  return n == 0 || pass < n;
+}
+
+GraphJohnson* GraphJohnsonCreate(const GraphCSR* csr) {
+  assert(csr != NULL);
+
+  GraphJohnson* j = (GraphJohnson*)malloc(sizeof(struct _GraphJohnson));
+  if (j == NULL) abort();
+
+  unsigned int n = GraphCSRGetNumVertices(csr);
+  unsigned int numArcs = GraphCSRGetNumArcs(csr);
+  j->csr = csr;
+  j->potential = (double*)malloc((n + 1) * sizeof(double));
+  j->weight = (double*)malloc((numArcs + 1) * sizeof(double));
+  if (j->potential == NULL || j->weight == NULL) abort();
+
+  if (!_computePotentials(j)) {
+    GraphJohnsonDestroy(&j);
+    return NULL;
+  }
+
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+  const double* weights = GraphCSRGetWeights(csr);
+  for (unsigned int u = 0; u < n; u++) {
+    for (unsigned int k = offsets[u]; k < offsets[u + 1]; k++) {
+      double w = (weights != NULL ? weights[k] : 1.0) + j->potential[u] -
+                 j->potential[targets[k]];
+      // Non-negative, up to rounding errors
+      j->weight[k] = w > 0.0 ? w : 0.0;
+    }
+  }
+
+  return j;
+}
+
+void GraphJohnsonDestroy(GraphJohnson** p) {
+  assert(*p != NULL);
+
+  GraphJohnson* j = *p;
+  free(j->potential);
+  free(j->weight);
+
+  free(*p);
+  *p = NULL;
+}
+
+GraphJohnsonSearch* GraphJohnsonSearchCreate(const GraphJohnson* j) {
+  assert(j != NULL);
+
+  GraphJohnsonSearch* s =
+      (GraphJohnsonSearch*)malloc(sizeof(struct _GraphJohnsonSearch));
+  if (s == NULL) abort();
+
+  unsigned int n = GraphCSRGetNumVertices(j->csr);
+  s->johnson = j;
+  s->reduced = (double*)malloc((n + 1) * sizeof(double));
+  s->distance = (double*)malloc((n + 1) * sizeof(double));
+  if (s->reduced == NULL || s->distance == NULL) abort();
+  s->heap = MinHeapCreate(n);
+
+  return s;
+}
+
+void GraphJohnsonSearchDestroy(GraphJohnsonSearch** p) {
+  assert(*p != NULL);
+
+  GraphJohnsonSearch* s = *p;
+  free(s->reduced);
+  free(s->distance);
+  MinHeapDestroy(&s->heap);
+
+  free(*p);
+  *p = NULL;
+}
+
+const double* GraphJohnsonSearchRun(GraphJohnsonSearch* s,
+                                    unsigned int source) {
+  assert(s != NULL);
+
+  const GraphJohnson* j = s->johnson;
+  unsigned int n = GraphCSRGetNumVertices(j->csr);
+  assert(source < n);
+
+  const unsigned int* offsets = GraphCSRGetOffsets(j->csr);
+  const unsigned int* targets = GraphCSRGetTargets(j->csr);
+
+  for (unsigned int v = 0; v < n; v++) {
+    s->reduced[v] = INFINITY;
+  }
+  s->reduced[source] = 0.0;
+  MinHeapInsert(s->heap, source, 0.0);
+
+  // Dijkstra, on the reweighted arcs
+  while (!MinHeapIsEmpty(s->heap)) {
+    unsigned int u = MinHeapRemoveMin(s->heap);
+    for (unsigned int k = offsets[u]; k < offsets[u + 1]; k++) {
+      unsigned int v = targets[k];
+      double candidate = s->reduced[u] + j->weight[k];
+      if (candidate < s->reduced[v]) {
+        s->reduced[v] = candidate;
+        MinHeapInsertOrDecrease(s->heap, v, candidate);
+      }
+    }
+  }
+
+  // Back to the original weights
+  for (unsigned int v = 0; v < n; v++) {
+    s->distance[v] = s->reduced[v] == INFINITY
+                         ? INFINITY
+                         : s->reduced[v] - j->potential[source] +
+                               j->potential[v];
+  }
+
+  return s->distance;
+}
@@ -0,0 +1,46 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphJohnson - Johnson's reweighting, for shortest paths from many sources
+//
+// Dijkstra's algorithm needs non-negative weights. Johnson's algorithm
+// computes a potential h(v) for each vertex, the distance to v from a
+// virtual source with a 0-weight arc to every vertex, by Bellman-Ford
+// (one run, O(VE), over GraphEdgeArrays). The reweighted arcs
+//   w'(u, v) = w(u, v) + h(u) - h(v)
+// are non-negative, and preserve the shortest paths; then each source
+// costs a single Dijkstra run, O(E log V), and
+//   d(s, t) = d'(s, t) - h(s) + h(t)
+// Unweighted graphs: each arc weighs 1.
+//
+
+#ifndef _GRAPH_JOHNSON_
+#define _GRAPH_JOHNSON_
+
+#include "GraphCSR.h"
+
+typedef struct _GraphJohnson GraphJohnson;
+
+// The shared part: the potentials and the reweighted arcs
+// Returns NULL if the graph has a negative cycle
+// The CSR snapshot is shared, not copied: it must outlive the result
+GraphJohnson* GraphJohnsonCreate(const GraphCSR* csr);
+
+void GraphJohnsonDestroy(GraphJohnson** p);
+
+// The Dijkstra runs: each thread needs its own search
+
+typedef struct _GraphJohnsonSearch GraphJohnsonSearch;
+
+GraphJohnsonSearch* GraphJohnsonSearchCreate(const GraphJohnson* j);
+
+void GraphJohnsonSearchDestroy(GraphJohnsonSearch** p);
+
+//
+// The distances from source to every vertex, INFINITY if not reachable
+// The array belongs to the search, and is overwritten by the next run
+//
+const double* GraphJohnsonSearchRun(GraphJohnsonSearch* s,
+                                    unsigned int source);
+
+#endif  // _GRAPH_JOHNSON_
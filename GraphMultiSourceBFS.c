@@ -0,0 +1,183 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphMultiSourceBFS - Bit-parallel multi-source breadth-first search
+//
+
+#include "GraphMultiSourceBFS.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "GraphCSR.h"
+
+// The word loops below are plain C, written to be auto-vectorized.
+// On x86-64 with GCC, an AVX2 clone is also compiled and selected at load
+// time, if the CPU supports it: 4 words = one 256-bit register per vertex.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && \
+    defined(__linux__)
+#define MSBFS_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define MSBFS_TARGET_CLONES
+#endif
+
+#define W GRAPH_MSBFS_WORDS
+
+struct _GraphMSBFS {
+  const GraphCSR* csr;
+  unsigned int numVertices;
+  uint64_t* seen;   // seen[W*v .. W*v+W-1]: the sources that reached v
+  uint64_t* visit;  // The current frontier of each source
+  uint64_t* next;   // The next frontier of each source
+};
+
+GraphMSBFS* GraphMSBFSCreate(const GraphCSR* csr) {
+  assert(csr != NULL);
+
+  GraphMSBFS* ms = (GraphMSBFS*)malloc(sizeof(struct _GraphMSBFS));
+  if (ms == NULL) abort();
+
+  ms->csr = csr;
+  ms->numVertices = GraphCSRGetNumVertices(csr);
+
+  size_t words = (size_t)(ms->numVertices + 1) * W;
+  ms->seen = (uint64_t*)calloc(words, sizeof(uint64_t));
+  ms->visit = (uint64_t*)calloc(words, sizeof(uint64_t));
+  ms->next = (uint64_t*)calloc(words, sizeof(uint64_t));
+  if (ms->seen == NULL || ms->visit == NULL || ms->next == NULL) abort();
+
+  return ms;
+}
+
+void GraphMSBFSDestroy(GraphMSBFS** p) {
+  assert(*p != NULL);
+
+  GraphMSBFS* aux = *p;
+
+  free(aux->seen);
+  free(aux->visit);
+  free(aux->next);
+
+  free(*p);
+  *p = NULL;
+}
+
+static inline int _anyBit(const uint64_t* words) {
+  uint64_t any = 0;
+  for (unsigned int k = 0; k < W; k++) {
+    any |= words[k];
+  }
+  return any != 0;
+}
+
+// Push the frontier of every vertex to its neighbours
+// The frontier words are cleared on the way, so that they can be
+// reused as the next frontier of the following level
+MSBFS_TARGET_CLONES
+static void _expandFrontier(const unsigned int* offsets,
+                            const unsigned int* targets, unsigned int n,
+                            uint64_t* restrict visit, uint64_t* restrict next) {
+  for (unsigned int v = 0; v < n; v++) {
+    uint64_t* visitV = visit + (size_t)v * W;
+    if (!_anyBit(visitV)) continue;
+
+    for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+      uint64_t* nextW = next + (size_t)targets[k] * W;
+      for (unsigned int i = 0; i < W; i++) {
+        nextW[i] |= visitV[i];
+      }
+    }
+
+    for (unsigned int i = 0; i < W; i++) {
+      visitV[i] = 0;
+    }
+  }
+}
+
+// Keep only the first visits and register them as seen
+// Returns 1 if some traversal is still active
+MSBFS_TARGET_CLONES
+static int _settleLevel(unsigned int n, unsigned int level,
+                        uint64_t* restrict seen, uint64_t* restrict next,
+                        GraphMSBFSVisitor visit, void* context) {
+  int active = 0;
+  for (unsigned int v = 0; v < n; v++) {
+    uint64_t* nextV = next + (size_t)v * W;
+    uint64_t* seenV = seen + (size_t)v * W;
+    uint64_t any = 0;
+    for (unsigned int i = 0; i < W; i++) {
+      nextV[i] &= ~seenV[i];
+      seenV[i] |= nextV[i];
+      any |= nextV[i];
+    }
+    if (any == 0) continue;
+
+    active = 1;
+    if (visit != NULL) {
+      visit(context, v, level, nextV);
+    }
+  }
+  return active;
+}
+
+unsigned int GraphMSBFSRun(GraphMSBFS* ms, const unsigned int* sources,
+                           unsigned int numSources, GraphMSBFSVisitor visit,
+                           void* context) {
+  assert(ms != NULL);
+  assert(sources != NULL);
+  assert(1 <= numSources && numSources <= GRAPH_MSBFS_MAX_SOURCES);
+
+  unsigned int n = ms->numVertices;
+  size_t words = (size_t)n * W;
+  memset(ms->seen, 0, words * sizeof(uint64_t));
+
+  // The frontier arrays are left cleared by the previous run
+
+  for (unsigned int i = 0; i < numSources; i++) {
+    assert(sources[i] < n);
+    uint64_t bit = (uint64_t)1 << (i % 64);
+    ms->seen[(size_t)sources[i] * W + i / 64] |= bit;
+    ms->visit[(size_t)sources[i] * W + i / 64] |= bit;
+  }
+
+  // Level 0: each source reaches itself
+  if (visit != NULL) {
+    uint64_t own[W];
+    for (unsigned int i = 0; i < numSources; i++) {
+      memset(own, 0, sizeof(own));
+      own[i / 64] = (uint64_t)1 << (i % 64);
+      visit(context, sources[i], 0, own);
+    }
+  }
+
+  const unsigned int* offsets = GraphCSRGetOffsets(ms->csr);
+  const unsigned int* targets = GraphCSRGetTargets(ms->csr);
+
+  unsigned int level = 0;
+  for (;;) {
+    _expandFrontier(offsets, targets, n, ms->visit, ms->next);
+
+    if (!_settleLevel(n, level + 1, ms->seen, ms->next, visit, context)) {
+      // Nothing new: the next frontier is all zeros, keep it cleared
+      break;
+    }
+    level++;
+
+    uint64_t* aux = ms->visit;
+    ms->visit = ms->next;
+    ms->next = aux;
+  }
+
+  return level;
+}
+
+int GraphMSBFSReached(const GraphMSBFS* ms, unsigned int sourceIndex,
+                      unsigned int v) {
+  assert(ms != NULL);
+  assert(sourceIndex < GRAPH_MSBFS_MAX_SOURCES);
+  assert(v < ms->numVertices);
+
+  uint64_t word = ms->seen[(size_t)v * W + sourceIndex / 64];
+  return (int)((word >> (sourceIndex % 64)) & 1);
+}
@@ -0,0 +1,55 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphMultiSourceBFS - Bit-parallel multi-source breadth-first search
+//
+// Up to GRAPH_MSBFS_MAX_SOURCES BFS traversals advance simultaneously.
+// Each vertex keeps one bit per source ("seen by source i"), so a single
+// scan of the adjacency of v serves every traversal whose frontier holds v
+// (MS-BFS, Then et al., VLDB 2014).
+// Only for unweighted graphs: levels are numbers of edges.
+//
+
+#ifndef _GRAPH_MULTI_SOURCE_BFS_
+#define _GRAPH_MULTI_SOURCE_BFS_
+
+#include <stdint.h>
+
+#include "GraphCSR.h"
+
+// Number of 64-bit words per vertex: 4 words = 256 sources per batch
+#define GRAPH_MSBFS_WORDS 4
+#define GRAPH_MSBFS_MAX_SOURCES (64 * GRAPH_MSBFS_WORDS)
+
+typedef struct _GraphMSBFS GraphMSBFS;
+
+//
+// Called once per vertex and level, with the set of sources of the batch
+// that reach the vertex for the first time at that level.
+// Bit i of newSources (word i / 64, bit i % 64) refers to sources[i].
+//
+typedef void (*GraphMSBFSVisitor)(void* context, unsigned int vertex,
+                                  unsigned int level,
+                                  const uint64_t* newSources);
+
+// The CSR snapshot is shared, not copied: it must outlive the engine
+GraphMSBFS* GraphMSBFSCreate(const GraphCSR* csr);
+
+void GraphMSBFSDestroy(GraphMSBFS** p);
+
+//
+// Run one batch of BFS traversals, from sources[0..numSources-1]
+// 1 <= numSources <= GRAPH_MSBFS_MAX_SOURCES
+// visit may be NULL, if only reachability is needed
+// Returns the number of levels of the deepest traversal
+//
+unsigned int GraphMSBFSRun(GraphMSBFS* ms, const unsigned int* sources,
+                           unsigned int numSources, GraphMSBFSVisitor visit,
+                           void* context);
+
+// After a run: was v reached from sources[sourceIndex]?
+
+int GraphMSBFSReached(const GraphMSBFS* ms, unsigned int sourceIndex,
+                      unsigned int v);
+
+#endif  // _GRAPH_MULTI_SOURCE_BFS_
@@ -0,0 +1,260 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphStronglyConnectedComponents - Strongly connected components, and
+// the condensation of a graph
+//
+
+#include "GraphStronglyConnectedComponents.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "GraphCSR.h"
+
+#define UNVISITED UINT_MAX
+
+struct _GraphSCC {
+  unsigned int numVertices;
+  unsigned int numComponents;
+  unsigned int* component;         // Per vertex
+  unsigned int* indexInComponent;  // Per vertex
+  unsigned int* componentOffsets;  // numComponents + 1
+  unsigned int* vertices;          // Grouped by component
+  unsigned int* condensationOffsets;  // numComponents + 1
+  unsigned int* condensationTargets;
+};
+
+// Tarjan's algorithm: fills component[] with numbers in the order the
+// components are found, i.e., in reverse topological order
+// Returns the number of components
+static unsigned int _tarjan(const GraphCSR* csr, unsigned int* component) {
+  unsigned int numVertices = GraphCSRGetNumVertices(csr);
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+
+  // Avoid malloc(0) for graphs without vertices
+  size_t size = (numVertices + 1) * sizeof(unsigned int);
+  unsigned int* index = (unsigned int*)malloc(size);
+  unsigned int* lowLink = (unsigned int*)malloc(size);
+  unsigned int* nextArc = (unsigned int*)malloc(size);
+  unsigned int* stack = (unsigned int*)malloc(size);      // Tarjan's stack
+  unsigned int* callStack = (unsigned int*)malloc(size);  // The recursion
+  if (index == NULL || lowLink == NULL || nextArc == NULL || stack == NULL ||
+      callStack == NULL) {
+    abort();
+  }
+
+  for (unsigned int v = 0; v < numVertices; v++) {
+    index[v] = UNVISITED;
+    component[v] = UNVISITED;  // Also: not on the stack, if visited
+  }
+
+  unsigned int counter = 0;
+  unsigned int stackTop = 0;
+  unsigned int numComponents = 0;
+  for (unsigned int root = 0; root < numVertices; root++) {
+    if (index[root] != UNVISITED) continue;
+
+    unsigned int callTop = 0;
+    callStack[callTop++] = root;
+    index[root] = lowLink[root] = counter++;
+    nextArc[root] = offsets[root];
+    stack[stackTop++] = root;
+
+    while (callTop > 0) {
+      unsigned int v = callStack[callTop - 1];
+      if (nextArc[v] < offsets[v + 1]) {
+        unsigned int w = targets[nextArc[v]++];
+        if (index[w] == UNVISITED) {
+          // "Recursive call" on w
+          index[w] = lowLink[w] = counter++;
+          nextArc[w] = offsets[w];
+          stack[stackTop++] = w;
+          callStack[callTop++] = w;
+        } else if (component[w] == UNVISITED && index[w] < lowLink[v]) {
+          // w is on the stack
+          lowLink[v] = index[w];
+        }
+        continue;
+      }
+
+      // All arcs of v were followed: "return" from v
+      callTop--;
+      if (lowLink[v] == index[v]) {
+        // v is the root of a component: the vertices above it, on the stack
+        unsigned int w;
+        do {
+          w = stack[--stackTop];
+          component[w] = numComponents;
+        } while (w != v);
+        numComponents++;
+      }
+      if (callTop > 0) {
+        unsigned int parent = callStack[callTop - 1];
+        if (lowLink[v] < lowLink[parent]) lowLink[parent] = lowLink[v];
+      }
+    }
+  }
+
+  free(index);
+  free(lowLink);
+  free(nextArc);
+  free(stack);
+  free(callStack);
+
+  return numComponents;
+}
+
+// The arcs between distinct components, without repetitions
+static void _condense(GraphSCC* p, const GraphCSR* csr) {
+  const unsigned int* offsets = GraphCSRGetOffsets(csr);
+  const unsigned int* targets = GraphCSRGetTargets(csr);
+  unsigned int numComponents = p->numComponents;
+
+  p->condensationOffsets =
+      (unsigned int*)malloc((numComponents + 1) * sizeof(unsigned int));
+  // lastSeen[d]: the last component with an arc to d
+  unsigned int* lastSeen =
+      (unsigned int*)malloc((numComponents + 1) * sizeof(unsigned int));
+  if (p->condensationOffsets == NULL || lastSeen == NULL) abort();
+
+  // Two passes: counting, then filling
+  p->condensationTargets = NULL;
+  for (int pass = 0; pass < 2; pass++) {
+    for (unsigned int d = 0; d < numComponents; d++) {
+      lastSeen[d] = UNVISITED;
+    }
+    unsigned int numArcs = 0;
+    for (unsigned int c = 0; c < numComponents; c++) {
+      p->condensationOffsets[c] = numArcs;
+      for (unsigned int i = p->componentOffsets[c];
+           i < p->componentOffsets[c + 1]; i++) {
+        unsigned int v = p->vertices[i];
+        for (unsigned int k = offsets[v]; k < offsets[v + 1]; k++) {
+          unsigned int d = p->component[targets[k]];
+          if (d == c || lastSeen[d] == c) continue;
+          lastSeen[d] = c;
+          if (pass == 1) p->condensationTargets[numArcs] = d;
+          numArcs++;
+        }
+      }
+    }
+    p->condensationOffsets[numComponents] = numArcs;
+
+    if (pass == 0) {
+      p->condensationTargets =
+          (unsigned int*)malloc((numArcs + 1) * sizeof(unsigned int));
+      if (p->condensationTargets == NULL) abort();
+    }
+  }
+
+  free(lastSeen);
+}
+
+GraphSCC* GraphSCCCompute(const GraphCSR* csr) {
+  assert(csr != NULL);
+
+  unsigned int numVertices = GraphCSRGetNumVertices(csr);
+
+  GraphSCC* p = (GraphSCC*)malloc(sizeof(struct _GraphSCC));
+  if (p == NULL) abort();
+
+  p->numVertices = numVertices;
+  size_t size = (numVertices + 1) * sizeof(unsigned int);
+  p->component = (unsigned int*)malloc(size);
+  p->indexInComponent = (unsigned int*)malloc(size);
+  p->vertices = (unsigned int*)malloc(size);
+  if (p->component == NULL || p->indexInComponent == NULL ||
+      p->vertices == NULL) {
+    abort();
+  }
+
+  p->numComponents = _tarjan(csr, p->component);
+
+  // Topological order: the first component found is the last one
+  for (unsigned int v = 0; v < numVertices; v++) {
+    p->component[v] = p->numComponents - 1 - p->component[v];
+  }
+
+  // Counting sort of the vertices by component, keeping the index order
+  p->componentOffsets =
+      (unsigned int*)calloc(p->numComponents + 1, sizeof(unsigned int));
+  if (p->componentOffsets == NULL) abort();
+  for (unsigned int v = 0; v < numVertices; v++) {
+    p->componentOffsets[p->component[v] + 1]++;
+  }
+  for (unsigned int c = 0; c < p->numComponents; c++) {
+    p->componentOffsets[c + 1] += p->componentOffsets[c];
+  }
+  for (unsigned int v = 0; v < numVertices; v++) {
+    unsigned int c = p->component[v];
+    // componentOffsets[c] is, for now, the next free position of c
+    p->indexInComponent[v] = p->componentOffsets[c];
+    p->vertices[p->componentOffsets[c]++] = v;
+  }
+  for (unsigned int c = p->numComponents; c > 0; c--) {
+    p->componentOffsets[c] = p->componentOffsets[c - 1];
+  }
+  p->componentOffsets[0] = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    p->indexInComponent[v] -= p->componentOffsets[p->component[v]];
+  }
+
+  _condense(p, csr);
+
+  return p;
+}
+
+void GraphSCCDestroy(GraphSCC** p) {
+  assert(*p != NULL);
+
+  GraphSCC* aux = *p;
+  free(aux->component);
+  free(aux->indexInComponent);
+  free(aux->componentOffsets);
+  free(aux->vertices);
+  free(aux->condensationOffsets);
+  free(aux->condensationTargets);
+
+  free(*p);
+  *p = NULL;
+}
+
+unsigned int GraphSCCGetNumComponents(const GraphSCC* p) {
+  assert(p != NULL);
+  return p->numComponents;
+}
+
+unsigned int GraphSCCGetComponent(const GraphSCC* p, unsigned int v) {
+  assert(p != NULL);
+  assert(v < p->numVertices);
+  return p->component[v];
+}
+
+unsigned int GraphSCCGetIndexInComponent(const GraphSCC* p, unsigned int v) {
+  assert(p != NULL);
+  assert(v < p->numVertices);
+  return p->indexInComponent[v];
+}
+
+const unsigned int* GraphSCCGetComponentOffsets(const GraphSCC* p) {
+  assert(p != NULL);
+  return p->componentOffsets;
+}
+
+const unsigned int* GraphSCCGetVertices(const GraphSCC* p) {
+  assert(p != NULL);
+  return p->vertices;
+}
+
+const unsigned int* GraphSCCGetCondensationOffsets(const GraphSCC* p) {
+  assert(p != NULL);
+  return p->condensationOffsets;
+}
+
+const unsigned int* GraphSCCGetCondensationTargets(const GraphSCC* p) {
+  assert(p != NULL);
+  return p->condensationTargets;
+}
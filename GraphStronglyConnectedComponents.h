@@ -0,0 +1,51 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphStronglyConnectedComponents - Strongly connected components, and
+// the condensation of a graph
+//
+// Tarjan's algorithm, with an explicit stack instead of recursion, on a
+// CSR snapshot: O(V + E).
+// The components are numbered in topological order of the condensation:
+// every arc between two components goes from a lower to a higher number,
+// so a component only reaches components with higher numbers.
+// For an undirected graph, the components are the connected components,
+// and the condensation has no arcs.
+//
+
+#ifndef _GRAPH_STRONGLY_CONNECTED_COMPONENTS_
+#define _GRAPH_STRONGLY_CONNECTED_COMPONENTS_
+
+#include "GraphCSR.h"
+
+typedef struct _GraphSCC GraphSCC;
+
+GraphSCC* GraphSCCCompute(const GraphCSR* csr);
+
+void GraphSCCDestroy(GraphSCC** p);
+
+unsigned int GraphSCCGetNumComponents(const GraphSCC* p);
+
+unsigned int GraphSCCGetComponent(const GraphSCC* p, unsigned int v);
+
+// Position of v among the vertices of its component
+unsigned int GraphSCCGetIndexInComponent(const GraphSCC* p, unsigned int v);
+
+// Flat arrays
+// The vertices of component c are
+// vertices[componentOffsets[c]] ... vertices[componentOffsets[c+1]-1],
+// by increasing index: vertices lists every vertex, grouped by component.
+
+const unsigned int* GraphSCCGetComponentOffsets(const GraphSCC* p);
+
+const unsigned int* GraphSCCGetVertices(const GraphSCC* p);
+
+// The condensation: the arcs from component c go to
+// targets[offsets[c]] ... targets[offsets[c+1]-1], without repetitions,
+// in no particular order.
+
+const unsigned int* GraphSCCGetCondensationOffsets(const GraphSCC* p);
+
+const unsigned int* GraphSCCGetCondensationTargets(const GraphSCC* p);
+
+#endif  // _GRAPH_STRONGLY_CONNECTED_COMPONENTS_
@@ -0,0 +1,116 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphTopologicalSorting - Topological order of the vertices of a digraph
+//
+
+#include "GraphTopologicalSorting.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Graph.h"
+
+struct _GraphTopoSort {
+  int validResult;  // 1: the digraph is acyclic
+  unsigned int* vertexSequence;  // The vertices, in the order they were
+                                 // output; only the first numOutput are set
+  unsigned int numOutput;
+  Graph* graph;
+};
+
+GraphTopoSort* GraphTopoSortCompute(Graph* g) {
+  assert(g != NULL);
+  assert(GraphIsDigraph(g) == 1);
+
+  unsigned int numVertices = GraphGetNumVertices(g);
+
+  GraphTopoSort* p = (GraphTopoSort*)malloc(sizeof(struct _GraphTopoSort));
+  if (p == NULL) abort();
+  p->graph = g;
+
+  // Avoid malloc(0) for graphs without vertices
+  p->vertexSequence =
+      (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  unsigned int* numEdgesPerVertex =
+      (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  if (p->vertexSequence == NULL || numEdgesPerVertex == NULL) abort();
+
+  // The sequence is also the FIFO queue: the vertices in
+  // vertexSequence[head .. numOutput-1] were not processed yet
+  p->numOutput = 0;
+  for (unsigned int v = 0; v < numVertices; v++) {
+    numEdgesPerVertex[v] = GraphGetVertexInDegree(g, v);
+    if (numEdgesPerVertex[v] == 0) {
+      p->vertexSequence[p->numOutput++] = v;
+    }
+  }
+
+  for (unsigned int head = 0; head < p->numOutput; head++) {
+    unsigned int v = p->vertexSequence[head];
+    unsigned int* adjacents = GraphGetAdjacentsTo(g, v);
+    for (unsigned int i = 1; i <= adjacents[0]; i++) {
+      unsigned int w = adjacents[i];
+      if (--numEdgesPerVertex[w] == 0) {
+        p->vertexSequence[p->numOutput++] = w;
+      }
+    }
+    free(adjacents);
+  }
+
+  free(numEdgesPerVertex);
+
+  p->validResult = (p->numOutput == numVertices);
+
+  return p;
+}
+
+void GraphTopoSortDestroy(GraphTopoSort** p) {
+  assert(*p != NULL);
+
+  GraphTopoSort* aux = *p;
+  free(aux->vertexSequence);
+
+  free(*p);
+  *p = NULL;
+}
+
+// Getting the result
+
+int GraphTopoSortIsValid(const GraphTopoSort* p) {
+  assert(p != NULL);
+  return p->validResult;
+}
+
+unsigned int* GraphTopoSortGetSequence(const GraphTopoSort* p) {
+  assert(p != NULL);
+
+  if (p->validResult == 0) return NULL;
+
+  unsigned int numVertices = GraphGetNumVertices(p->graph);
+  unsigned int* sequence =
+      (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  if (sequence == NULL) abort();
+  memcpy(sequence, p->vertexSequence, numVertices * sizeof(unsigned int));
+
+  return sequence;
+}
+
+// DISPLAYING on the console
+
+void GraphTopoSortDisplaySequence(const GraphTopoSort* p) {
+  assert(p != NULL);
+
+  if (p->validResult == 0) {
+    printf(" *** The topological sorting could not be computed!! *** \n");
+    return;
+  }
+
+  printf("Topological Sorting - Vertex sequence:\n");
+  for (unsigned int i = 0; i < GraphGetNumVertices(p->graph); i++) {
+    printf("%u ", p->vertexSequence[i]);
+  }
+  printf("\n");
+}
@@ -0,0 +1,39 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// GraphTopologicalSorting - Topological order of the vertices of a digraph
+//
+// Kahn's algorithm: the in-degree of every vertex, as tracked by the graph,
+// is copied; vertices with no remaining in-edges are output in FIFO order,
+// and their out-edges are removed from the copy.
+// O(V + E); if some vertices are never output, the digraph has a cycle.
+//
+
+#ifndef _GRAPH_TOPOLOGICAL_SORTING_
+#define _GRAPH_TOPOLOGICAL_SORTING_
+
+#include "Graph.h"
+
+typedef struct _GraphTopoSort GraphTopoSort;
+
+GraphTopoSort* GraphTopoSortCompute(Graph* g);
+
+void GraphTopoSortDestroy(GraphTopoSort** p);
+
+// Getting the result
+
+// 1 if the digraph is acyclic (the order is valid), 0 otherwise
+int GraphTopoSortIsValid(const GraphTopoSort* p);
+
+//
+// Returns an array of size numVertices, with the vertices in topological
+// order: every edge goes from an earlier to a later vertex
+// Returns NULL, if the digraph has a cycle
+//
+unsigned int* GraphTopoSortGetSequence(const GraphTopoSort* p);
+
+// DISPLAYING on the console
+
+void GraphTopoSortDisplaySequence(const GraphTopoSort* p);
+
+#endif  // _GRAPH_TOPOLOGICAL_SORTING_
@@ -20,20 +20,26 @@
 #include <stdlib.h>
 
 #include "Graph.h"
-#include "GraphBellmanFordAlg.h"
+#include "GraphCSR.h"
+#include "GraphMultiSourceBFS.h"
 #include "instrumentation.h"
 
 // Compute the transitive closure of a directed graph
 // Return the computed transitive closure as a directed graph
-// Use the Bellman-Ford algorithm
 // Função para calcular o fecho transitivo de um grafo orientado
+// Os vértices de origem são processados em lotes de GRAPH_MSBFS_MAX_SOURCES,
+// com uma BFS multi-fonte (bit-paralela) por lote
 
-// Função auxiliar para adicionar arestas de alcance
-static void AdicionarArestasDeAlcance(Graph* fecho, GraphBellmanFordAlg* algoritmo, unsigned int verticeOrigem, unsigned int totalVertices) {
-    for (unsigned int destino = 0; destino < totalVertices; destino++) {
-        // Verifica se o destino é alcançável e não cria self-loops
-        if (GraphBellmanFordAlgReached(algoritmo, destino) && verticeOrigem != destino) {
-            GraphAddEdge(fecho, verticeOrigem, destino);
+// Função auxiliar para adicionar arestas de alcance de todas as origens do lote
+// Os destinos são percorridos por ordem crescente: cada inserção na lista de
+// adjacências ordenada é feita na cauda, em tempo constante
+static void AdicionarArestasDeAlcance(Graph* fecho, const GraphMSBFS* bfs, const unsigned int* origens, unsigned int numOrigens, unsigned int totalVertices) {
+    for (unsigned int i = 0; i < numOrigens; i++) {
+        for (unsigned int destino = 0; destino < totalVertices; destino++) {
+            // Verifica se o destino é alcançável e não cria self-loops
+            if (origens[i] != destino && GraphMSBFSReached(bfs, i, destino)) {
+                GraphAddEdge(fecho, origens[i], destino);
+            }
         }
     }
 }
@@ -52,22 +58,31 @@ Graph* GraphComputeTransitiveClosure(Graph* grafo) {
     Graph* fechoTransitivo = GraphCreate(totalVertices, 1, 0);
     if (fechoTransitivo == NULL) return NULL;
 
-    // Para cada vértice do grafo original
-    for (unsigned int origem = 0; origem < totalVertices; origem++) {
-        // Executa o algoritmo de Bellman-Ford a partir do vértice atual
-        GraphBellmanFordAlg* algoritmoBF = GraphBellmanFordAlgExecute(grafo, origem);
-        if (algoritmoBF == NULL) {
-            GraphDestroy(&fechoTransitivo); // Libera memória em caso de erro
-            return NULL;
+    // Cópia compacta das listas de adjacências, partilhada por todos os lotes
+    GraphCSR* adjacencias = GraphCSRCreate(grafo);
+    GraphMSBFS* bfs = GraphMSBFSCreate(adjacencias);
+
+    unsigned int origens[GRAPH_MSBFS_MAX_SOURCES];
+
+    // Para cada lote de vértices do grafo original
+    for (unsigned int primeira = 0; primeira < totalVertices; primeira += GRAPH_MSBFS_MAX_SOURCES) {
+        unsigned int numOrigens = totalVertices - primeira;
+        if (numOrigens > GRAPH_MSBFS_MAX_SOURCES) numOrigens = GRAPH_MSBFS_MAX_SOURCES;
+
+        for (unsigned int i = 0; i < numOrigens; i++) {
+            origens[i] = primeira + i;
         }
 
-        // Adiciona arestas ao fecho transitivo
-        AdicionarArestasDeAlcance(fechoTransitivo, algoritmoBF, origem, totalVertices);
+        // Executa as BFS de todas as origens do lote em simultâneo
+        GraphMSBFSRun(bfs, origens, numOrigens, NULL, NULL);
 
-        // Libera a memória alocada para o algoritmo de Bellman-Ford
-        GraphBellmanFordAlgDestroy(&algoritmoBF);
+        // Adiciona arestas ao fecho transitivo
+        AdicionarArestasDeAlcance(fechoTransitivo, bfs, origens, numOrigens, totalVertices);
     }
 
+    GraphMSBFSDestroy(&bfs);
+    GraphCSRDestroy(&adjacencias);
+
     // Retorna o grafo representando o fecho transitivo
     return fechoTransitivo;
 }
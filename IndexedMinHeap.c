@@ -0,0 +1,139 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Indexed binary MIN-HEAP of items 0 .. capacity-1, with double keys
+//
+
+#include "IndexedMinHeap.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+struct _IndexedMinHeap {
+  unsigned int capacity;  // items are 0 .. capacity-1
+  unsigned int size;      // current number of items in the heap
+  unsigned int* items;    // the heap array
+  double* keys;           // keys[i] is the key of items[i]
+  unsigned int* pos;      // pos[item] = 1 + its index in the heap array
+                          // pos[item] = 0, if item is not in the heap
+};
+
+MinHeap* MinHeapCreate(unsigned int capacity) {
+  MinHeap* h = (MinHeap*)malloc(sizeof(MinHeap));
+  if (h == NULL) abort();
+  h->capacity = capacity;
+  h->size = 0;
+  h->items = (unsigned int*)malloc((capacity + 1) * sizeof(unsigned int));
+  h->keys = (double*)malloc((capacity + 1) * sizeof(double));
+  h->pos = (unsigned int*)calloc(capacity + 1, sizeof(unsigned int));
+  if (h->items == NULL || h->keys == NULL || h->pos == NULL) abort();
+  return h;
+}
+
+void MinHeapDestroy(MinHeap** p) {
+  assert(*p != NULL);
+  MinHeap* h = *p;
+  free(h->items);
+  free(h->keys);
+  free(h->pos);
+  free(h);
+  *p = NULL;
+}
+
+void MinHeapClear(MinHeap* h) {
+  for (unsigned int i = 0; i < h->size; i++) {
+    h->pos[h->items[i]] = 0;
+  }
+  h->size = 0;
+}
+
+unsigned int MinHeapSize(const MinHeap* h) { return h->size; }
+
+int MinHeapIsEmpty(const MinHeap* h) { return (h->size == 0); }
+
+int MinHeapContains(const MinHeap* h, unsigned int item) {
+  assert(item < h->capacity);
+  return (h->pos[item] != 0);
+}
+
+unsigned int MinHeapPeekMin(const MinHeap* h) {
+  assert(h->size > 0);
+  return h->items[0];
+}
+
+double MinHeapPeekMinKey(const MinHeap* h) {
+  assert(h->size > 0);
+  return h->keys[0];
+}
+
+// Place (item, key) at index i and update its position
+static void _place(MinHeap* h, unsigned int i, unsigned int item, double key) {
+  h->items[i] = item;
+  h->keys[i] = key;
+  h->pos[item] = i + 1;
+}
+
+static void _siftUp(MinHeap* h, unsigned int i) {
+  unsigned int item = h->items[i];
+  double key = h->keys[i];
+  while (i > 0) {
+    unsigned int parent = (i - 1) / 2;
+    if (h->keys[parent] <= key) break;
+    _place(h, i, h->items[parent], h->keys[parent]);
+    i = parent;
+  }
+  _place(h, i, item, key);
+}
+
+static void _siftDown(MinHeap* h, unsigned int i) {
+  unsigned int item = h->items[i];
+  double key = h->keys[i];
+  for (;;) {
+    unsigned int child = 2 * i + 1;
+    if (child >= h->size) break;
+    if (child + 1 < h->size && h->keys[child + 1] < h->keys[child]) {
+      child++;
+    }
+    if (key <= h->keys[child]) break;
+    _place(h, i, h->items[child], h->keys[child]);
+    i = child;
+  }
+  _place(h, i, item, key);
+}
+
+void MinHeapInsert(MinHeap* h, unsigned int item, double key) {
+  assert(item < h->capacity);
+  assert(h->pos[item] == 0);
+  _place(h, h->size, item, key);
+  h->size++;
+  _siftUp(h, h->size - 1);
+}
+
+void MinHeapDecreaseKey(MinHeap* h, unsigned int item, double key) {
+  assert(MinHeapContains(h, item));
+  unsigned int i = h->pos[item] - 1;
+  assert(key <= h->keys[i]);
+  h->keys[i] = key;
+  _siftUp(h, i);
+}
+
+void MinHeapInsertOrDecrease(MinHeap* h, unsigned int item, double key) {
+  assert(item < h->capacity);
+  if (h->pos[item] == 0) {
+    MinHeapInsert(h, item, key);
+  } else if (key < h->keys[h->pos[item] - 1]) {
+    MinHeapDecreaseKey(h, item, key);
+  }
+}
+
+unsigned int MinHeapRemoveMin(MinHeap* h) {
+  assert(h->size > 0);
+  unsigned int min = h->items[0];
+  h->pos[min] = 0;
+  h->size--;
+  if (h->size > 0) {
+    _place(h, 0, h->items[h->size], h->keys[h->size]);
+    _siftDown(h, 0);
+  }
+  return min;
+}
@@ -0,0 +1,43 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Indexed binary MIN-HEAP of items 0 .. capacity-1, with double keys
+//
+// Each item is in the heap at most once; its position is tracked,
+// so that its key can be decreased in O(log n) (e.g., for Dijkstra).
+//
+
+#ifndef _INDEXED_MIN_HEAP_
+#define _INDEXED_MIN_HEAP_
+
+typedef struct _IndexedMinHeap MinHeap;
+
+MinHeap* MinHeapCreate(unsigned int capacity);
+
+void MinHeapDestroy(MinHeap** p);
+
+// O(size): only the items in the heap are touched
+void MinHeapClear(MinHeap* h);
+
+unsigned int MinHeapSize(const MinHeap* h);
+
+int MinHeapIsEmpty(const MinHeap* h);
+
+int MinHeapContains(const MinHeap* h, unsigned int item);
+
+unsigned int MinHeapPeekMin(const MinHeap* h);
+
+double MinHeapPeekMinKey(const MinHeap* h);
+
+// Insert an item not in the heap
+void MinHeapInsert(MinHeap* h, unsigned int item, double key);
+
+// The new key must not be larger than the current one
+void MinHeapDecreaseKey(MinHeap* h, unsigned int item, double key);
+
+// Insert the item, or decrease its key; a larger key is ignored
+void MinHeapInsertOrDecrease(MinHeap* h, unsigned int item, double key);
+
+unsigned int MinHeapRemoveMin(MinHeap* h);
+
+#endif  // _INDEXED_MIN_HEAP_
@@ -201,6 +201,14 @@ int ListInsert(List* l, void* p) {
     return 0;
   }
 
+  // Items inserted in increasing order: append without searching
+  if (l->compare(p, l->tail->item) > 0) {
+    l->tail->next = sn;
+    l->tail = sn;
+    l->size++;
+    return 0;
+  }
+
   // Search
   struct _ListNode* prev = NULL;
   struct _ListNode* aux = l->head;
@@ -7,9 +7,15 @@
 //
 
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "Graph.h"
 #include "GraphAllPairsShortestDistances.h"
+#include "GraphBellmanFordAlg.h"
+#include "GraphCSR.h"
+#include "GraphFloydWarshall.h"
 
 int main(void) {
   // What kind of graph is dig01?
@@ -47,10 +53,422 @@ int main(void) {
 
   GraphAllPairsShortestDistancesPrint(distancesMatrix);
 
+  // The same distances, computed by one Bellman-Ford run per vertex
+  GraphAllPairsShortestDistancesOptions options =
+      GraphAllPairsShortestDistancesDefaultOptions();
+  options.engine = GRAPH_APSD_ENGINE_BELLMAN_FORD;
+  GraphAllPairsShortestDistances* bfMatrix =
+      GraphAllPairsShortestDistancesExecuteWithOptions(dig03, &options);
+
+  for (unsigned int v = 0; v < GraphGetNumVertices(dig03); v++) {
+    for (unsigned int w = 0; w < GraphGetNumVertices(dig03); w++) {
+      assert(GraphGetDistanceVW(bfMatrix, v, w) ==
+             GraphGetDistanceVW(distancesMatrix, v, w));
+    }
+  }
+
+  GraphAllPairsShortestDistancesDestroy(&bfMatrix);
+
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // A directed path with 300 vertices: distances beyond one byte
+  Graph* dig04 = GraphCreate(300, 1, 0);
+  for (unsigned int v = 0; v + 1 < 300; v++) {
+    GraphAddEdge(dig04, v, v + 1);
+  }
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig04);
+  assert(GraphGetDistanceVW(distancesMatrix, 0, 299) == 299);
+  assert(GraphGetDistanceVW(distancesMatrix, 10, 265) == 255);
+  assert(GraphGetDistanceVW(distancesMatrix, 299, 0) == -1);
+
+  // A single thread gives the same matrix, with both engines
+  options.numThreads = 1;
+  bfMatrix = GraphAllPairsShortestDistancesExecuteWithOptions(dig04, &options);
+  options.engine = GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS;
+  GraphAllPairsShortestDistances* bfsMatrix =
+      GraphAllPairsShortestDistancesExecuteWithOptions(dig04, &options);
+  for (unsigned int v = 0; v < 300; v++) {
+    for (unsigned int w = 0; w < 300; w++) {
+      assert(GraphGetDistanceVW(bfMatrix, v, w) ==
+             GraphGetDistanceVW(distancesMatrix, v, w));
+      assert(GraphGetDistanceVW(bfsMatrix, v, w) ==
+             GraphGetDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  GraphAllPairsShortestDistancesDestroy(&bfsMatrix);
+  GraphAllPairsShortestDistancesDestroy(&bfMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // A weighted digraph, with a negative weight
+  Graph* dig05 = GraphCreate(5, 1, 1);
+  GraphAddWeightedEdge(dig05, 0, 1, 4.0);
+  GraphAddWeightedEdge(dig05, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig05, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig05, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig05, 3, 2, 1.0);
+  GraphAddWeightedEdge(dig05, 3, 0, 0.5);
+
+  // Dense: Floyd-Warshall, by default
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig05);
+  GraphAllPairsShortestDistancesPrint(distancesMatrix);
+  assert(GraphGetWeightedDistanceVW(distancesMatrix, 0, 3) == 2.5);
+  assert(GraphGetWeightedDistanceVW(distancesMatrix, 3, 1) == -0.5);
+  assert(GraphGetWeightedDistanceVW(distancesMatrix, 0, 4) == INFINITY);
+
+  options.engine = GRAPH_APSD_ENGINE_BELLMAN_FORD;
+  bfMatrix = GraphAllPairsShortestDistancesExecuteWithOptions(dig05, &options);
+  for (unsigned int v = 0; v < 5; v++) {
+    for (unsigned int w = 0; w < 5; w++) {
+      assert(GraphGetWeightedDistanceVW(bfMatrix, v, w) ==
+             GraphGetWeightedDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  GraphAllPairsShortestDistancesDestroy(&bfMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // Sparse, with negative weights: Johnson's algorithm, by default
+  Graph* dig07 = GraphCreate(20, 1, 1);
+  for (unsigned int v = 0; v < 20; v++) {
+    GraphAddWeightedEdge(dig07, v, (v + 1) % 20, v % 3 == 0 ? -1.0 : 2.0);
+  }
+  GraphAddWeightedEdge(dig07, 0, 10, 4.0);
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig07);
+  assert(GraphGetWeightedDistanceVW(distancesMatrix, 0, 19) == 13.0);
+  assert(GraphGetWeightedDistanceVW(distancesMatrix, 1, 0) == 20.0);
+  bfMatrix = GraphAllPairsShortestDistancesExecuteWithOptions(dig07, &options);
+  for (unsigned int v = 0; v < 20; v++) {
+    for (unsigned int w = 0; w < 20; w++) {
+      assert(GraphGetWeightedDistanceVW(bfMatrix, v, w) ==
+             GraphGetWeightedDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  GraphAllPairsShortestDistancesDestroy(&bfMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // The negative cycle 0 -> 2 -> 1 -> 3 -> 0
+  Graph* dig06 = GraphCreate(4, 1, 1);
+  GraphAddWeightedEdge(dig06, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig06, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig06, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig06, 3, 0, -3.0);
+  options.engine = GRAPH_APSD_ENGINE_FLOYD_WARSHALL;
+  assert(GraphAllPairsShortestDistancesExecuteWithOptions(dig06, &options) ==
+         NULL);
+  options.engine = GRAPH_APSD_ENGINE_BELLMAN_FORD;
+  assert(GraphAllPairsShortestDistancesExecuteWithOptions(dig06, &options) ==
+         NULL);
+  options.engine = GRAPH_APSD_ENGINE_JOHNSON;
+  assert(GraphAllPairsShortestDistancesExecuteWithOptions(dig06, &options) ==
+         NULL);
+
+  // An undirected 12 x 12 grid, with one weight per row: only the upper
+  // triangle is stored
+  Graph* g08 = GraphCreate(144, 0, 1);
+  Graph* g09 = GraphCreate(144, 0, 0);
+  for (unsigned int r = 0; r < 12; r++) {
+    for (unsigned int c = 0; c < 12; c++) {
+      if (c + 1 < 12) {
+        GraphAddWeightedEdge(g08, 12 * r + c, 12 * r + c + 1, 1.0 + r);
+        GraphAddEdge(g09, 12 * r + c, 12 * r + c + 1);
+      }
+      if (r + 1 < 12) {
+        GraphAddWeightedEdge(g08, 12 * r + c, 12 * (r + 1) + c, 0.5);
+        GraphAddEdge(g09, 12 * r + c, 12 * (r + 1) + c);
+      }
+    }
+  }
+  Graph* undirected[] = {g08, g09};
+  GraphAllPairsShortestDistancesEngine engines[] = {
+      GRAPH_APSD_ENGINE_BELLMAN_FORD, GRAPH_APSD_ENGINE_FLOYD_WARSHALL,
+      GRAPH_APSD_ENGINE_JOHNSON, GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS};
+  for (unsigned int i = 0; i < 2; i++) {
+    for (unsigned int e = 0; e < 4; e++) {
+      if (GraphIsWeighted(undirected[i]) &&
+          engines[e] == GRAPH_APSD_ENGINE_MULTI_SOURCE_BFS) {
+        continue;
+      }
+      options.engine = engines[e];
+      distancesMatrix =
+          GraphAllPairsShortestDistancesExecuteWithOptions(undirected[i], &options);
+      assert(GraphAllPairsShortestDistancesGetMemoryBytes(distancesMatrix) <
+             144 * 73 * (GraphIsWeighted(undirected[i]) ? 8 : 1) + 64);
+      for (unsigned int v = 0; v < 144; v++) {
+        GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(undirected[i], v);
+        for (unsigned int w = 0; w < 144; w++) {
+          assert(GraphGetWeightedDistanceVW(distancesMatrix, v, w) ==
+                 GraphBellmanFordAlgWeightedDistance(bf, w));
+        }
+        GraphBellmanFordAlgDestroy(&bf);
+      }
+      GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+    }
+  }
+  GraphDestroy(&g08);
+  GraphDestroy(&g09);
+
+  // 40 directed 4-cycles, with a few weighted arcs between them: most
+  // pairs have no path, and only the reachable blocks are stored
+  Graph* dig10 = GraphCreate(160, 1, 1);
+  for (unsigned int c = 0; c < 40; c++) {
+    for (unsigned int i = 0; i < 4; i++) {
+      GraphAddWeightedEdge(dig10, 4 * c + i, 4 * c + (i + 1) % 4, 1.0 + i);
+    }
+    if (c % 3 != 2 && c + 1 < 40) {
+      GraphAddWeightedEdge(dig10, 4 * c + 1, 4 * (c + 1) + 2, -2.0);
+    }
+  }
+  for (unsigned int e = 0; e < 3; e++) {
+    options.engine = engines[e];
+    distancesMatrix = GraphAllPairsShortestDistancesExecuteWithOptions(dig10, &options);
+    if (engines[e] != GRAPH_APSD_ENGINE_FLOYD_WARSHALL) {
+      assert(GraphAllPairsShortestDistancesGetMemoryBytes(distancesMatrix) <
+             160 * 160 * 8 / 4);
+    }
+    for (unsigned int v = 0; v < 160; v++) {
+      GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(dig10, v);
+      for (unsigned int w = 0; w < 160; w++) {
+        assert(GraphGetWeightedDistanceVW(distancesMatrix, v, w) ==
+               GraphBellmanFordAlgWeightedDistance(bf, w));
+      }
+      GraphBellmanFordAlgDestroy(&bf);
+    }
+    GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+  }
+  GraphDestroy(&dig10);
+
+  // On demand, with room for 4 rows of dig04 (2-byte entries)
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig04);
+  GraphAllPairsShortestDistances* lazyMatrix =
+      GraphAllPairsShortestDistancesCreateLazy(dig04, 4 * 300 * 2);
+  for (unsigned int v = 0; v < 300; v++) {
+    for (unsigned int w = 0; w < 300; w++) {
+      assert(GraphGetDistanceVW(lazyMatrix, v, w) ==
+             GraphGetDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  GraphDistanceRowCacheStats stats =
+      GraphAllPairsShortestDistancesGetCacheStats(lazyMatrix);
+  assert(stats.maxRows == 4 && stats.numRows == 4);
+  assert(stats.misses == 300 && stats.evictions == 296);
+  assert(stats.hits == 300 * 299);
+  // Row 298 is cached, row 0 was evicted
+  assert(GraphGetDistanceVW(lazyMatrix, 298, 299) == 1);
+  assert(GraphGetDistanceVW(lazyMatrix, 0, 299) == 299);
+  stats = GraphAllPairsShortestDistancesGetCacheStats(lazyMatrix);
+  assert(stats.misses == 301 && stats.evictions == 297);
+  GraphAllPairsShortestDistancesDestroy(&lazyMatrix);
   GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
 
+  // On demand, weighted: Johnson's reweighting, then one Dijkstra per row
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig07);
+  lazyMatrix = GraphAllPairsShortestDistancesCreateLazy(dig07, 0);
+  for (unsigned int w = 0; w < 20; w++) {
+    for (unsigned int v = 0; v < 20; v++) {
+      assert(GraphGetWeightedDistanceVW(lazyMatrix, v, w) ==
+             GraphGetWeightedDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  stats = GraphAllPairsShortestDistancesGetCacheStats(lazyMatrix);
+  assert(stats.maxRows == 1 && stats.misses == 400);
+  GraphAllPairsShortestDistancesDestroy(&lazyMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+  assert(GraphAllPairsShortestDistancesCreateLazy(dig06, 1 << 20) == NULL);
+
+  // Batched queries, in no particular order: 1000 pairs from 10 sources
+  unsigned int sources[1000];
+  unsigned int targets[1000];
+  int batch[1000];
+  double weightedBatch[1000];
+  for (unsigned int i = 0; i < 1000; i++) {
+    sources[i] = (37 * i) % 10 * 29;
+    targets[i] = (7919 * i) % 300;
+  }
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig04);
+  lazyMatrix = GraphAllPairsShortestDistancesCreateLazy(dig04, 300 * 2);
+  GraphGetDistancesVW(distancesMatrix, sources, targets, 1000, batch);
+  for (unsigned int i = 0; i < 1000; i++) {
+    assert(batch[i] == GraphGetDistanceVW(distancesMatrix, sources[i], targets[i]));
+  }
+  // One row at a time: each source is computed once
+  GraphGetWeightedDistancesVW(lazyMatrix, sources, targets, 1000, weightedBatch);
+  for (unsigned int i = 0; i < 1000; i++) {
+    assert(weightedBatch[i] ==
+           GraphGetWeightedDistanceVW(distancesMatrix, sources[i], targets[i]));
+  }
+  stats = GraphAllPairsShortestDistancesGetCacheStats(lazyMatrix);
+  assert(stats.misses == 10 && stats.hits == 0);
+  GraphAllPairsShortestDistancesDestroy(&lazyMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // Weighted, and a small batch
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig07);
+  for (unsigned int i = 0; i < 1000; i++) {
+    targets[i] %= 20;
+    sources[i] = (sources[i] * 13) % 20;
+  }
+  GraphGetWeightedDistancesVW(distancesMatrix, sources, targets, 1000,
+                              weightedBatch);
+  for (unsigned int i = 0; i < 1000; i++) {
+    assert(weightedBatch[i] ==
+           GraphGetWeightedDistanceVW(distancesMatrix, sources[i], targets[i]));
+  }
+  GraphGetWeightedDistancesVW(distancesMatrix, sources + 5, targets + 5, 1,
+                              weightedBatch);
+  assert(weightedBatch[0] ==
+         GraphGetWeightedDistanceVW(distancesMatrix, sources[5], targets[5]));
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // Out of core, with room for 100 rows of dig04: windows of 64 rows
+  char path[] = "/tmp/TestAllPairsShortestDistancesXXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  close(fd);
+  options = GraphAllPairsShortestDistancesDefaultOptions();
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig04);
+  GraphAllPairsShortestDistances* fileMatrix =
+      GraphAllPairsShortestDistancesExecuteToFile(dig04, path, 100 * 300 * 2,
+                                                  &options);
+  assert(fileMatrix != NULL);
+  for (unsigned int v = 0; v < 300; v++) {
+    for (unsigned int w = 0; w < 300; w++) {
+      assert(GraphGetDistanceVW(fileMatrix, v, w) ==
+             GraphGetDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  for (unsigned int i = 0; i < 1000; i++) {
+    sources[i] = (7919 * i) % 300;
+    targets[i] = (37 * i) % 300;
+  }
+  GraphGetDistancesVW(fileMatrix, sources, targets, 1000, batch);
+  for (unsigned int i = 0; i < 1000; i++) {
+    assert(batch[i] == GraphGetDistanceVW(distancesMatrix, sources[i], targets[i]));
+  }
+  GraphAllPairsShortestDistancesDestroy(&fileMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // Weighted, 3 rows at a time
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig07);
+  fileMatrix = GraphAllPairsShortestDistancesExecuteToFile(dig07, path,
+                                                           3 * 20 * 8, &options);
+  for (unsigned int v = 0; v < 20; v++) {
+    for (unsigned int w = 0; w < 20; w++) {
+      assert(GraphGetWeightedDistanceVW(fileMatrix, v, w) ==
+             GraphGetWeightedDistanceVW(distancesMatrix, v, w));
+    }
+  }
+  GraphAllPairsShortestDistancesDestroy(&fileMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+
+  // A negative cycle: no result, and the file is removed
+  assert(GraphAllPairsShortestDistancesExecuteToFile(dig06, path, 1 << 20,
+                                                     &options) == NULL);
+  assert(access(path, F_OK) != 0);
+
+  // Inserting edges: two undirected paths 0 - ... - 9 and 10 - ... - 19,
+  // joined by a new edge, then a shortcut; the distances outgrow the
+  // entries of the first matrix
+  Graph* g11 = GraphCreate(20, 0, 0);
+  for (unsigned int v = 0; v + 1 < 20; v++) {
+    if (v != 9) GraphAddEdge(g11, v, v + 1);
+  }
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(g11);
+  GraphAddEdge(g11, 9, 10);
+  assert(GraphAllPairsShortestDistancesAddEdge(distancesMatrix, 9, 10));
+  GraphAddEdge(g11, 2, 17);
+  assert(GraphAllPairsShortestDistancesAddEdge(distancesMatrix, 2, 17));
+  bfMatrix = GraphAllPairsShortestDistancesExecute(g11);
+  for (unsigned int v = 0; v < 20; v++) {
+    for (unsigned int w = 0; w < 20; w++) {
+      assert(GraphGetDistanceVW(distancesMatrix, v, w) ==
+             GraphGetDistanceVW(bfMatrix, v, w));
+    }
+  }
+  GraphAllPairsShortestDistancesDestroy(&bfMatrix);
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+  GraphDestroy(&g11);
+
+  // 20 weighted directed 4-cycles, stored by blocks: new arcs between
+  // cycles, then an arc back that merges two of them, added together
+  Graph* dig12 = GraphCreate(80, 1, 1);
+  for (unsigned int c = 0; c < 20; c++) {
+    for (unsigned int i = 0; i < 4; i++) {
+      GraphAddWeightedEdge(dig12, 4 * c + i, 4 * c + (i + 1) % 4, 1.0 + i);
+    }
+  }
+  distancesMatrix = GraphAllPairsShortestDistancesExecute(dig12);
+  unsigned int tails[] = {3, 7, 41, 6};
+  unsigned int heads[] = {4, 40, 8, 1};
+  double weights[] = {-2.0, 0.5, 1.5, 0.0};
+  for (unsigned int i = 0; i < 4; i++) {
+    GraphAddWeightedEdge(dig12, tails[i], heads[i], weights[i]);
+  }
+  assert(GraphAllPairsShortestDistancesAddEdge(distancesMatrix, 3, 4));
+  assert(GraphAllPairsShortestDistancesAddEdges(distancesMatrix, tails + 1,
+                                                heads + 1, 3));
+  for (unsigned int v = 0; v < 80; v++) {
+    GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(dig12, v);
+    for (unsigned int w = 0; w < 80; w++) {
+      assert(GraphGetWeightedDistanceVW(distancesMatrix, v, w) ==
+             GraphBellmanFordAlgWeightedDistance(bf, w));
+    }
+    GraphBellmanFordAlgDestroy(&bf);
+  }
+  // A negative cycle: 1 -> 2 -> 3 -> 1
+  GraphAddWeightedEdge(dig12, 3, 1, -6.0);
+  assert(!GraphAllPairsShortestDistancesAddEdge(distancesMatrix, 3, 1));
+  GraphAllPairsShortestDistancesDestroy(&distancesMatrix);
+  GraphDestroy(&dig12);
+
+  // On demand: the cached rows are dropped
+  Graph* dig13 = GraphCreate(10, 1, 0);
+  for (unsigned int v = 0; v + 1 < 10; v++) {
+    GraphAddEdge(dig13, v, v + 1);
+  }
+  lazyMatrix = GraphAllPairsShortestDistancesCreateLazy(dig13, 1 << 10);
+  assert(GraphGetDistanceVW(lazyMatrix, 0, 9) == 9);
+  GraphAddEdge(dig13, 0, 8);
+  assert(GraphAllPairsShortestDistancesAddEdge(lazyMatrix, 0, 8));
+  assert(GraphGetDistanceVW(lazyMatrix, 0, 9) == 2);
+  GraphAllPairsShortestDistancesDestroy(&lazyMatrix);
+  GraphDestroy(&dig13);
+
+  // Floyd-Warshall, with every supported kernel: 70 vertices fill 3 tiles,
+  // the last one padded; the negative arcs go forward, and the arcs back
+  // are too heavy to close a negative cycle
+  Graph* dig14 = GraphCreate(70, 1, 1);
+  for (unsigned int v = 0; v < 70; v++) {
+    if (v + 1 < 70) GraphAddWeightedEdge(dig14, v, v + 1, (double)(v % 4) - 1.0);
+    if (v + 17 < 70) GraphAddWeightedEdge(dig14, v, v + 17, (double)(v % 3) - 1.5);
+    if (v % 5 == 0 && v > 0) GraphAddWeightedEdge(dig14, v, v / 3, 100.0);
+  }
+  GraphCSR* csr14 = GraphCSRCreate(dig14);
+  for (GraphFloydWarshallKernel kernel = GRAPH_FLOYD_WARSHALL_KERNEL_SCALAR;
+       kernel <= GRAPH_FLOYD_WARSHALL_KERNEL_AVX2; kernel++) {
+    if (!GraphFloydWarshallKernelIsSupported(kernel)) continue;
+    for (unsigned int numThreads = 1; numThreads <= 3; numThreads += 2) {
+      GraphFloydWarshall* fw =
+          GraphFloydWarshallExecuteWithKernel(csr14, numThreads, kernel);
+      assert(!GraphFloydWarshallHasNegativeCycle(fw));
+      for (unsigned int v = 0; v < 70; v++) {
+        GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(dig14, v);
+        for (unsigned int w = 0; w < 70; w++) {
+          assert(GraphFloydWarshallGetDistance(fw, v, w) ==
+                 GraphBellmanFordAlgWeightedDistance(bf, w));
+        }
+        GraphBellmanFordAlgDestroy(&bf);
+      }
+      GraphFloydWarshallDestroy(&fw);
+    }
+  }
+  GraphCSRDestroy(&csr14);
+  GraphDestroy(&dig14);
+
   GraphDestroy(&dig01);
   GraphDestroy(&dig03);
+  GraphDestroy(&dig04);
+  GraphDestroy(&dig05);
+  GraphDestroy(&dig06);
+  GraphDestroy(&dig07);
 
   return 0;
 }
@@ -7,9 +7,14 @@
 //
 
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
 
 #include "Graph.h"
 #include "GraphBellmanFordAlg.h"
+#include "GraphCSR.h"
+#include "GraphEdgeArrays.h"
+#include "GraphFrontier.h"
 
 int main(void) {
   // What kind of graph is dig01?
@@ -90,6 +95,418 @@ int main(void) {
     GraphBellmanFordAlgDestroy(&BF_result);
   }
 
+  // The direction-optimizing BFS must find the same distances
+  GraphBellmanFordAlgOptions options = GraphBellmanFordAlgDefaultOptions();
+  options.engine = GRAPH_BF_ENGINE_DIRECTION_OPTIMIZING_BFS;
+  options.alpha = 1.0;  // Switch to bottom-up early, to exercise both steps
+  // And so must a reused workspace, without predecessors
+  GraphBellmanFordAlgOptions wsOptions = GraphBellmanFordAlgDefaultOptions();
+  wsOptions.trackPredecessors = 0;
+  GraphBellmanFordAlgWorkspace* ws = GraphBellmanFordAlgWorkspaceCreate(dig03);
+  // And the edge-centric engine
+  GraphBellmanFordAlgOptions edgeOptions = GraphBellmanFordAlgDefaultOptions();
+  edgeOptions.engine = GRAPH_BF_ENGINE_EDGE_CENTRIC;
+  for (unsigned int i = 0; i < GraphGetNumVertices(dig03); i++) {
+    GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(dig03, i);
+    GraphBellmanFordAlg* BFS_result =
+        GraphBellmanFordAlgExecuteWithOptions(dig03, i, &options);
+    const GraphBellmanFordAlg* WS_result =
+        GraphBellmanFordAlgExecuteInWorkspace(ws, i, &wsOptions);
+    GraphBellmanFordAlg* edge_result =
+        GraphBellmanFordAlgExecuteWithOptions(dig03, i, &edgeOptions);
+
+    for (unsigned int v = 0; v < GraphGetNumVertices(dig03); v++) {
+      assert(GraphBellmanFordAlgReached(BF_result, v) ==
+             GraphBellmanFordAlgReached(BFS_result, v));
+      assert(GraphBellmanFordAlgReached(BF_result, v) ==
+             GraphBellmanFordAlgReached(WS_result, v));
+      assert(GraphBellmanFordAlgReached(BF_result, v) ==
+             GraphBellmanFordAlgReached(edge_result, v));
+      assert(GraphBellmanFordAlgDistance(BF_result, v) ==
+             GraphBellmanFordAlgDistance(BFS_result, v));
+      assert(GraphBellmanFordAlgDistance(BF_result, v) ==
+             GraphBellmanFordAlgDistance(WS_result, v));
+      assert(GraphBellmanFordAlgDistance(BF_result, v) ==
+             GraphBellmanFordAlgDistance(edge_result, v));
+    }
+
+    GraphBellmanFordAlgDestroy(&BF_result);
+    GraphBellmanFordAlgDestroy(&BFS_result);
+    GraphBellmanFordAlgDestroy(&edge_result);
+  }
+  GraphBellmanFordAlgWorkspaceDestroy(&ws);
+
+  // The paths to every vertex, in one buffer, must match PathTo
+  for (unsigned int i = 0; i < GraphGetNumVertices(dig03); i++) {
+    GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(dig03, i);
+    GraphBellmanFordAlgPaths* paths = GraphBellmanFordAlgPathsTo(BF_result, NULL, 0);
+    assert(GraphBellmanFordAlgPathsGetNumPaths(paths) == GraphGetNumVertices(dig03));
+
+    for (unsigned int v = 0; v < GraphGetNumVertices(dig03); v++) {
+      Stack* s = GraphBellmanFordAlgPathTo(BF_result, v);
+      const unsigned int* path = GraphBellmanFordAlgPathsGetPath(paths, v);
+      assert(GraphBellmanFordAlgPathsGetLength(paths, v) == (unsigned int)StackSize(s));
+      for (unsigned int k = 0; StackIsEmpty(s) == 0; k++) {
+        assert(path[k] == (unsigned int)StackPop(s));
+      }
+      StackDestroy(&s);
+    }
+
+    GraphBellmanFordAlgPathsDestroy(&paths);
+    GraphBellmanFordAlgDestroy(&BF_result);
+  }
+
+  // Limited to 2 edges, both engines reach the vertices at distance <= 2
+  options.maxHops = 2;
+  GraphBellmanFordAlgOptions hopRelaxation = GraphBellmanFordAlgDefaultOptions();
+  hopRelaxation.maxHops = 2;
+  for (unsigned int i = 0; i < GraphGetNumVertices(dig03); i++) {
+    GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(dig03, i);
+    GraphBellmanFordAlg* BFS_result =
+        GraphBellmanFordAlgExecuteWithOptions(dig03, i, &options);
+    GraphBellmanFordAlg* hop_result =
+        GraphBellmanFordAlgExecuteWithOptions(dig03, i, &hopRelaxation);
+
+    for (unsigned int v = 0; v < GraphGetNumVertices(dig03); v++) {
+      int d = GraphBellmanFordAlgDistance(BF_result, v);
+      int expected = (d >= 0 && d <= 2) ? d : -1;
+      assert(GraphBellmanFordAlgDistance(BFS_result, v) == expected);
+      assert(GraphBellmanFordAlgDistance(hop_result, v) == expected);
+    }
+
+    GraphBellmanFordAlgDestroy(&BF_result);
+    GraphBellmanFordAlgDestroy(&BFS_result);
+    GraphBellmanFordAlgDestroy(&hop_result);
+  }
+
+  // A weighted digraph, with negative weights but no negative cycle
+  Graph* dig04 = GraphCreate(5, 1, 1);
+  GraphAddWeightedEdge(dig04, 0, 1, 4.0);
+  GraphAddWeightedEdge(dig04, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig04, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig04, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig04, 3, 2, 1.0);
+
+  // By default, the edge-centric engine
+  GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(dig04, 0);
+  GraphBellmanFordAlgOptions relaxOptions = GraphBellmanFordAlgDefaultOptions();
+  relaxOptions.engine = GRAPH_BF_ENGINE_RELAXATION;
+  GraphBellmanFordAlg* relax_result =
+      GraphBellmanFordAlgExecuteWithOptions(dig04, 0, &relaxOptions);
+  assert(GraphBellmanFordAlgHasNegativeCycle(BF_result) == 0);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 1) == 0.5);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 3) == 2.5);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 4) == INFINITY);
+  for (unsigned int v = 0; v < 5; v++) {
+    assert(GraphBellmanFordAlgWeightedDistance(BF_result, v) ==
+           GraphBellmanFordAlgWeightedDistance(relax_result, v));
+  }
+  GraphBellmanFordAlgDestroy(&relax_result);
+  printf("Shortest path from 0 to 3: ");
+  GraphBellmanFordAlgShowPath(BF_result, 3);
+  printf("\n");
+  GraphBellmanFordAlgDestroy(&BF_result);
+
+  // At most 1, 2 and 3 edges
+  GraphBellmanFordAlgOptions hopOptions = GraphBellmanFordAlgDefaultOptions();
+  const double hopDistance1[] = {4.0, 0.5, 0.5};
+  const double hopDistance3[] = {INFINITY, 6.0, 2.5};
+  for (unsigned int k = 1; k <= 3; k++) {
+    hopOptions.maxHops = k;
+    BF_result = GraphBellmanFordAlgExecuteWithOptions(dig04, 0, &hopOptions);
+    assert(GraphBellmanFordAlgWeightedDistance(BF_result, 1) == hopDistance1[k - 1]);
+    assert(GraphBellmanFordAlgWeightedDistance(BF_result, 3) == hopDistance3[k - 1]);
+    GraphBellmanFordAlgDestroy(&BF_result);
+  }
+
+  // The same digraph, closing the negative cycle 1 -> 3 -> 2 -> 1
+  Graph* dig05 = GraphCreate(5, 1, 1);
+  GraphAddWeightedEdge(dig05, 0, 1, 4.0);
+  GraphAddWeightedEdge(dig05, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig05, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig05, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig05, 3, 2, -1.0);
+  assert(GraphBellmanFordAlgExecute(dig05, 0) == NULL);
+
+  GraphBellmanFordAlgOptions cycleOptions = GraphBellmanFordAlgDefaultOptions();
+  cycleOptions.reportNegativeCycle = 1;
+  BF_result = GraphBellmanFordAlgExecuteWithOptions(dig05, 0, &cycleOptions);
+  assert(GraphBellmanFordAlgHasNegativeCycle(BF_result));
+  unsigned int* cycle = GraphBellmanFordAlgGetNegativeCycle(BF_result);
+  printf("Negative cycle:");
+  for (unsigned int i = 1; i <= cycle[0]; i++) {
+    printf(" %u", cycle[i]);
+  }
+  printf("\n");
+  // Some rotation of 1 3 2, in the order of the edges
+  const unsigned int expected[] = {1, 3, 2};
+  assert(cycle[0] == 3);
+  unsigned int first = 0;
+  while (expected[first] != cycle[1]) first++;
+  for (unsigned int i = 0; i < 3; i++) {
+    assert(cycle[i + 1] == expected[(first + i) % 3]);
+  }
+  free(cycle);
+  GraphBellmanFordAlgDestroy(&BF_result);
+
+  // Not reachable from 4: no cycle is found
+  BF_result = GraphBellmanFordAlgExecuteWithOptions(dig05, 4, &cycleOptions);
+  assert(GraphBellmanFordAlgHasNegativeCycle(BF_result) == 0);
+  GraphBellmanFordAlgDestroy(&BF_result);
+
+  // Inserting edges: the repaired results must match new runs
+  Graph* dig06 = GraphCreate(6, 1, 1);
+  GraphAddWeightedEdge(dig06, 0, 1, 5.0);
+  GraphAddWeightedEdge(dig06, 1, 2, 1.0);
+  GraphAddWeightedEdge(dig06, 2, 3, 1.0);
+  GraphAddWeightedEdge(dig06, 4, 5, 2.0);
+  GraphBellmanFordAlg* before[6];
+  for (unsigned int i = 0; i < 6; i++) {
+    before[i] = GraphBellmanFordAlgExecute(dig06, i);
+  }
+  const unsigned int tails[] = {0, 3, 2};
+  const unsigned int heads[] = {2, 4, 1};
+  GraphAddWeightedEdge(dig06, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig06, 3, 4, -0.5);
+  GraphAddWeightedEdge(dig06, 2, 1, 1.0);
+  for (unsigned int i = 0; i < 6; i++) {
+    assert(GraphBellmanFordAlgUpdateAfterInsertions(before[i], tails, heads, 3));
+    GraphBellmanFordAlg* after = GraphBellmanFordAlgExecute(dig06, i);
+    for (unsigned int v = 0; v < 6; v++) {
+      assert(GraphBellmanFordAlgWeightedDistance(before[i], v) ==
+             GraphBellmanFordAlgWeightedDistance(after, v));
+    }
+    GraphBellmanFordAlgDestroy(&after);
+  }
+  printf("Shortest path from 0 to 5, after the insertions: ");
+  GraphBellmanFordAlgShowPath(before[0], 5);
+  printf("\n");
+  // A second update of the same results
+  const unsigned int back = 5;
+  const unsigned int front = 0;
+  GraphAddWeightedEdge(dig06, 5, 0, 1.0);
+  for (unsigned int i = 0; i < 6; i++) {
+    assert(GraphBellmanFordAlgUpdateAfterInsertions(before[i], &back, &front, 1));
+    GraphBellmanFordAlg* after = GraphBellmanFordAlgExecute(dig06, i);
+    for (unsigned int v = 0; v < 6; v++) {
+      assert(GraphBellmanFordAlgWeightedDistance(before[i], v) ==
+             GraphBellmanFordAlgWeightedDistance(after, v));
+    }
+    GraphBellmanFordAlgDestroy(&after);
+  }
+  // Closing the negative cycle 1 -> 2 -> 3 -> 4 -> 1
+  const unsigned int tail = 4;
+  const unsigned int head = 1;
+  GraphAddWeightedEdge(dig06, 4, 1, -2.0);
+  assert(GraphBellmanFordAlgUpdateAfterInsertions(before[0], &tail, &head, 1) == 0);
+  for (unsigned int i = 0; i < 6; i++) {
+    GraphBellmanFordAlgDestroy(&before[i]);
+  }
+
+  // An acyclic digraph, with a negative weight: relaxed in topological order
+  Graph* dig07 = GraphCreate(6, 1, 1);
+  GraphAddWeightedEdge(dig07, 0, 1, 3.0);
+  GraphAddWeightedEdge(dig07, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig07, 1, 3, 4.0);
+  GraphAddWeightedEdge(dig07, 2, 3, 1.0);
+  GraphAddWeightedEdge(dig07, 2, 1, -2.0);
+  GraphAddWeightedEdge(dig07, 3, 4, 2.0);
+  GraphBellmanFordAlgStats dagStats;
+  GraphBellmanFordAlgOptions dagOptions = GraphBellmanFordAlgDefaultOptions();
+  dagOptions.stats = &dagStats;
+  BF_result = GraphBellmanFordAlgExecuteWithOptions(dig07, 0, &dagOptions);
+  assert(dagStats.rounds == 1);
+  relax_result = GraphBellmanFordAlgExecuteWithOptions(dig07, 0, &relaxOptions);
+  for (unsigned int v = 0; v < 6; v++) {
+    assert(GraphBellmanFordAlgWeightedDistance(BF_result, v) ==
+           GraphBellmanFordAlgWeightedDistance(relax_result, v));
+  }
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 4) == 5.0);
+  GraphBellmanFordAlgDestroy(&relax_result);
+  GraphBellmanFordAlgDestroy(&BF_result);
+
+  // The critical path: 0 -> 1 -> 3 -> 4
+  dagOptions.longestPath = 1;
+  BF_result = GraphBellmanFordAlgExecuteWithOptions(dig07, 0, &dagOptions);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 1) == 3.0);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 3) == 7.0);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 4) == 9.0);
+  assert(GraphBellmanFordAlgWeightedDistance(BF_result, 5) == INFINITY);
+  printf("Longest path from 0 to 4: ");
+  GraphBellmanFordAlgShowPath(BF_result, 4);
+  printf("\n");
+  GraphBellmanFordAlgDestroy(&BF_result);
+
+  // A frontier of 400 vertices: listed up to 400 / 32 = 12 vertices
+  GraphFrontier* frontier = GraphFrontierCreate(400);
+  for (unsigned int i = 0; i < 12; i++) {
+    assert(GraphFrontierAdd(frontier, 397 - 33 * i));
+  }
+  assert(!GraphFrontierAdd(frontier, 397));
+  assert(!GraphFrontierIsDense(frontier) && GraphFrontierSize(frontier) == 12);
+  unsigned int cursor = 0;
+  unsigned int v;
+  unsigned int count = 0;
+  while (GraphFrontierNext(frontier, &cursor, &v)) {
+    assert(v == 397 - 33 * count);  // In the order of insertion
+    count++;
+  }
+  assert(count == 12);
+  // Cleared while sparse: only the listed words are reset
+  GraphFrontierClear(frontier);
+  assert(GraphFrontierSize(frontier) == 0);
+  for (unsigned int w = 0; w < 400; w++) {
+    assert(!GraphFrontierContains(frontier, w));
+  }
+  for (unsigned int w = 0; w < (400 + 63) / 64; w++) {
+    assert(GraphFrontierGetBitmap(frontier)[w] == 0);
+  }
+  // The 13th vertex switches to the dense form
+  for (unsigned int i = 0; i < 13; i++) {
+    assert(GraphFrontierAdd(frontier, 390 - 30 * i));
+    assert(GraphFrontierIsDense(frontier) == (i == 12));
+  }
+  assert(GraphFrontierSize(frontier) == 13);
+  assert(GraphFrontierContains(frontier, 30) && !GraphFrontierContains(frontier, 31));
+  cursor = 0;
+  count = 0;
+  while (GraphFrontierNext(frontier, &cursor, &v)) {
+    assert(v == 30 * (count + 1));  // By increasing index
+    count++;
+  }
+  assert(count == 13);
+  GraphFrontierClear(frontier);
+  assert(!GraphFrontierIsDense(frontier) && GraphFrontierSize(frontier) == 0);
+  for (unsigned int w = 0; w < 400; w++) {
+    assert(!GraphFrontierContains(frontier, w));
+  }
+  // Up to 200 listed vertices
+  GraphFrontierSetDenseDivisor(frontier, 2);
+  for (unsigned int w = 0; w < 200; w++) {
+    GraphFrontierAdd(frontier, w);
+  }
+  assert(!GraphFrontierIsDense(frontier));
+  GraphFrontierAdd(frontier, 399);
+  assert(GraphFrontierIsDense(frontier) && GraphFrontierSize(frontier) == 201);
+  GraphFrontierDestroy(&frontier);
+
+  // A 20 x 20 grid, with arcs right and down: the frontiers are diagonals,
+  // and outgrow the sparse form halfway
+  Graph* dig08 = GraphCreate(400, 1, 0);
+  Graph* dig09 = GraphCreate(400, 1, 1);
+  for (unsigned int r = 0; r < 20; r++) {
+    for (unsigned int c = 0; c < 20; c++) {
+      if (c + 1 < 20) {
+        GraphAddEdge(dig08, 20 * r + c, 20 * r + c + 1);
+        GraphAddWeightedEdge(dig09, 20 * r + c, 20 * r + c + 1, 1.0 + (r * c) % 3);
+      }
+      if (r + 1 < 20) {
+        GraphAddEdge(dig08, 20 * r + c, 20 * (r + 1) + c);
+        GraphAddWeightedEdge(dig09, 20 * r + c, 20 * (r + 1) + c, 2.0 - (r + c) % 2);
+      }
+    }
+  }
+  GraphBellmanFordAlgOptions bfsOptions = GraphBellmanFordAlgDefaultOptions();
+  bfsOptions.engine = GRAPH_BF_ENGINE_DIRECTION_OPTIMIZING_BFS;
+  relaxOptions = GraphBellmanFordAlgDefaultOptions();
+  relaxOptions.engine = GRAPH_BF_ENGINE_RELAXATION;
+  unsigned int starts[] = {0, 21, 210, 399};
+  for (unsigned int i = 0; i < 4; i++) {
+    GraphBellmanFordAlg* reference = GraphBellmanFordAlgExecute(dig08, starts[i]);
+    GraphBellmanFordAlg* bfs =
+        GraphBellmanFordAlgExecuteWithOptions(dig08, starts[i], &bfsOptions);
+    GraphBellmanFordAlg* relax =
+        GraphBellmanFordAlgExecuteWithOptions(dig08, starts[i], &relaxOptions);
+    for (unsigned int w = 0; w < 400; w++) {
+      assert(GraphBellmanFordAlgDistance(bfs, w) ==
+             GraphBellmanFordAlgDistance(reference, w));
+      assert(GraphBellmanFordAlgDistance(relax, w) ==
+             GraphBellmanFordAlgDistance(reference, w));
+    }
+    GraphBellmanFordAlgDestroy(&reference);
+    GraphBellmanFordAlgDestroy(&bfs);
+    GraphBellmanFordAlgDestroy(&relax);
+
+    reference = GraphBellmanFordAlgExecute(dig09, starts[i]);
+    relax = GraphBellmanFordAlgExecuteWithOptions(dig09, starts[i], &relaxOptions);
+    for (unsigned int w = 0; w < 400; w++) {
+      assert(GraphBellmanFordAlgWeightedDistance(relax, w) ==
+             GraphBellmanFordAlgWeightedDistance(reference, w));
+    }
+    GraphBellmanFordAlgDestroy(&reference);
+    GraphBellmanFordAlgDestroy(&relax);
+  }
+  GraphDestroy(&dig08);
+  GraphDestroy(&dig09);
+
+  // Every supported edge kernel must give the same passes as the scalar one,
+  // on a weighted DAG with negative weights: vertices 40 to 46 have a single
+  // arc each, into 47, so that one vector holds several arcs into 47
+  Graph* dig10 = GraphCreate(48, 1, 1);
+  for (unsigned int u = 0; u < 39; u++) {
+    GraphAddWeightedEdge(dig10, u, u + 1, (double)(u % 5) - 2.0);
+    if (u + 3 < 40) {
+      GraphAddWeightedEdge(dig10, u, u + 3, (double)(u % 7) - 1.0);
+    }
+  }
+  for (unsigned int v = 40; v < 47; v++) {
+    GraphAddWeightedEdge(dig10, 39, v, (double)(v % 3) - 1.0);
+    GraphAddWeightedEdge(dig10, v, 47, 2.0 - (double)(v % 4));
+  }
+  GraphCSR* csr10 = GraphCSRCreate(dig10);
+  GraphEdgeArrays* ea10 = GraphEdgeArraysCreate(csr10);
+  double scalarDistance[48];
+  int scalarPredecessor[48];
+  unsigned int scalarMarked[48];
+  for (GraphEdgeKernel kernel = GRAPH_EDGE_KERNEL_SCALAR;
+       kernel <= GRAPH_EDGE_KERNEL_AVX512; kernel++) {
+    if (!GraphEdgeArraysKernelIsSupported(kernel)) continue;
+    GraphEdgeArraysSetKernel(ea10, kernel);
+
+    double distance[48];
+    double previous[48];
+    int predecessor[48];
+    unsigned int marked[48];
+    for (unsigned int v = 0; v < 48; v++) {
+      distance[v] = INFINITY;
+      predecessor[v] = -1;
+      marked[v] = 0;
+    }
+    distance[0] = 0.0;
+    // One pass reads the distances of the previous one: the result of a
+    // pass does not depend on the width of the vectors
+    unsigned int stamp = 1;
+    unsigned int updates;
+    do {
+      for (unsigned int v = 0; v < 48; v++) previous[v] = distance[v];
+      updates = GraphEdgeArraysRelax(ea10, previous, distance, predecessor,
+                                     marked, stamp++);
+    } while (updates > 0);
+
+    if (kernel == GRAPH_EDGE_KERNEL_SCALAR) {
+      GraphBellmanFordAlg* reference = GraphBellmanFordAlgExecute(dig10, 0);
+      for (unsigned int v = 0; v < 48; v++) {
+        assert(distance[v] == GraphBellmanFordAlgWeightedDistance(reference, v));
+        scalarDistance[v] = distance[v];
+        scalarPredecessor[v] = predecessor[v];
+        scalarMarked[v] = marked[v];
+      }
+      GraphBellmanFordAlgDestroy(&reference);
+    }
+    for (unsigned int v = 0; v < 48; v++) {
+      assert(distance[v] == scalarDistance[v]);
+      assert(predecessor[v] == scalarPredecessor[v]);
+      assert(marked[v] == scalarMarked[v]);
+    }
+  }
+  GraphEdgeArraysDestroy(&ea10);
+  GraphCSRDestroy(&csr10);
+  GraphDestroy(&dig10);
+
+  GraphDestroy(&dig04);
+  GraphDestroy(&dig05);
+  GraphDestroy(&dig06);
+  GraphDestroy(&dig07);
   GraphDestroy(&g01);
   GraphDestroy(&dig01);
   GraphDestroy(&dig03);
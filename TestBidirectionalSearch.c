@@ -0,0 +1,80 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Testing the point-to-point bidirectional search
+//
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphBellmanFordAlg.h"
+#include "GraphBidirectionalSearch.h"
+
+static void printPath(GraphBidirectionalSearch* bs, unsigned int s,
+                      unsigned int t) {
+  unsigned int* path = GraphBidirectionalSearchPath(bs, s, t);
+  printf("Path from %u to %u (distance %g):", s, t,
+         GraphBidirectionalSearchDistance(bs, s, t));
+  for (unsigned int i = 1; i <= path[0]; i++) {
+    printf(" %u", path[i]);
+  }
+  printf("\n");
+  free(path);
+}
+
+int main(void) {
+  // Reading a directed graph from file
+  FILE* file = fopen("DG_2.txt", "r");
+  Graph* dig03 = GraphFromFile(file);
+  fclose(file);
+
+  GraphCheckInvariants(dig03);
+
+  // Every pair: compare with the Bellman-Ford distances
+  GraphBidirectionalSearch* bs = GraphBidirectionalSearchCreate(dig03);
+  for (unsigned int s = 0; s < GraphGetNumVertices(dig03); s++) {
+    GraphBellmanFordAlg* BF_result = GraphBellmanFordAlgExecute(dig03, s);
+    for (unsigned int t = 0; t < GraphGetNumVertices(dig03); t++) {
+      double d = GraphBidirectionalSearchDistance(bs, s, t);
+      assert(d == (double)GraphBellmanFordAlgDistance(BF_result, t));
+
+      unsigned int* path = GraphBidirectionalSearchPath(bs, s, t);
+      if (d >= 0.0) {
+        assert(path[0] == (unsigned int)d + 1);
+        assert(path[1] == s && path[path[0]] == t);
+      } else {
+        assert(path[0] == 0);
+      }
+      free(path);
+    }
+    GraphBellmanFordAlgDestroy(&BF_result);
+  }
+
+  printPath(bs, 0, 14);
+  printPath(bs, 7, 0);
+  GraphBidirectionalSearchDestroy(&bs);
+
+  // A weighted graph: the direct edge is not the shortest path
+  Graph* g01 = GraphCreate(5, 0, 1);
+  GraphAddWeightedEdge(g01, 0, 4, 10.0);
+  GraphAddWeightedEdge(g01, 0, 1, 1.0);
+  GraphAddWeightedEdge(g01, 1, 2, 2.0);
+  GraphAddWeightedEdge(g01, 2, 3, 1.5);
+  GraphAddWeightedEdge(g01, 3, 4, 0.5);
+
+  GraphCheckInvariants(g01);
+
+  bs = GraphBidirectionalSearchCreate(g01);
+  printPath(bs, 0, 4);
+  assert(GraphBidirectionalSearchDistance(bs, 0, 4) == 5.0);
+  assert(GraphBidirectionalSearchDistance(bs, 4, 1) == 4.0);
+  GraphBidirectionalSearchDestroy(&bs);
+
+  assert(GraphShortestDistance(g01, 2, 0) == 3.0);
+
+  GraphDestroy(&dig03);
+  GraphDestroy(&g01);
+
+  return 0;
+}
@@ -0,0 +1,146 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Testing the pruned landmark labeling
+//
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphBellmanFordAlg.h"
+#include "GraphDistanceLabeling.h"
+
+// Every query must give the exact distance
+static void CheckLabeling(Graph* g, const GraphDistanceLabeling* labeling) {
+  unsigned int numVertices = GraphGetNumVertices(g);
+  assert(GraphDistanceLabelingGetNumVertices(labeling) == numVertices);
+
+  for (unsigned int v = 0; v < numVertices; v++) {
+    GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(g, v);
+    for (unsigned int w = 0; w < numVertices; w++) {
+      double distance = GraphBellmanFordAlgWeightedDistance(bf, w);
+      assert(GraphDistanceLabelingGetWeightedDistanceVW(labeling, v, w) ==
+             distance);
+      if (!GraphIsWeighted(g)) {
+        int hops = GraphDistanceLabelingGetDistanceVW(labeling, v, w);
+        assert(distance == INFINITY ? hops == -1 : hops == (int)distance);
+      }
+    }
+    GraphBellmanFordAlgDestroy(&bf);
+  }
+}
+
+// Saving to a temporary file, and loading back
+static GraphDistanceLabeling* SaveAndLoad(const GraphDistanceLabeling* p) {
+  FILE* f = tmpfile();
+  assert(f != NULL);
+  assert(GraphDistanceLabelingSave(p, f));
+  rewind(f);
+  GraphDistanceLabeling* loaded = GraphDistanceLabelingLoad(f);
+  fclose(f);
+  assert(loaded != NULL);
+  assert(GraphDistanceLabelingGetNumEntries(loaded) ==
+         GraphDistanceLabelingGetNumEntries(p));
+  return loaded;
+}
+
+int main(void) {
+  // A 10 x 10 grid, and a separate edge
+  Graph* g01 = GraphCreate(102, 0, 0);
+  for (unsigned int r = 0; r < 10; r++) {
+    for (unsigned int c = 0; c < 10; c++) {
+      if (c + 1 < 10) GraphAddEdge(g01, 10 * r + c, 10 * r + c + 1);
+      if (r + 1 < 10) GraphAddEdge(g01, 10 * r + c, 10 * (r + 1) + c);
+    }
+  }
+  GraphAddEdge(g01, 100, 101);
+
+  GraphDistanceLabeling* labeling = GraphDistanceLabelingCreate(g01);
+  CheckLabeling(g01, labeling);
+  printf("Grid: %zu label entries, %zu bytes\n",
+         GraphDistanceLabelingGetNumEntries(labeling),
+         GraphDistanceLabelingGetMemoryBytes(labeling));
+  assert(GraphDistanceLabelingGetNumEntries(labeling) < 102 * 102 / 2);
+
+  GraphDistanceLabeling* loaded = SaveAndLoad(labeling);
+  assert(!GraphDistanceLabelingIsDigraph(loaded));
+  assert(!GraphDistanceLabelingIsWeighted(loaded));
+  CheckLabeling(g01, loaded);
+  GraphDistanceLabelingDestroy(&loaded);
+  GraphDistanceLabelingDestroy(&labeling);
+
+  // A star: the center covers every path
+  Graph* g02 = GraphCreate(50, 0, 0);
+  for (unsigned int v = 1; v < 50; v++) {
+    GraphAddEdge(g02, 0, v);
+  }
+  labeling = GraphDistanceLabelingCreate(g02);
+  CheckLabeling(g02, labeling);
+  assert(GraphDistanceLabelingGetNumEntries(labeling) == 1 + 2 * 49);
+  GraphDistanceLabelingDestroy(&labeling);
+
+  // A weighted digraph, with a zero weight
+  Graph* dig03 = GraphCreate(8, 1, 1);
+  GraphAddWeightedEdge(dig03, 0, 1, 4.0);
+  GraphAddWeightedEdge(dig03, 0, 2, 1.5);
+  GraphAddWeightedEdge(dig03, 2, 1, 0.0);
+  GraphAddWeightedEdge(dig03, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig03, 3, 2, 1.0);
+  GraphAddWeightedEdge(dig03, 3, 4, 0.5);
+  GraphAddWeightedEdge(dig03, 5, 0, 3.0);
+  GraphAddWeightedEdge(dig03, 4, 6, 2.5);
+  GraphAddWeightedEdge(dig03, 6, 0, 1.0);
+  labeling = GraphDistanceLabelingCreate(dig03);
+  CheckLabeling(dig03, labeling);
+  loaded = SaveAndLoad(labeling);
+  assert(GraphDistanceLabelingIsDigraph(loaded));
+  assert(GraphDistanceLabelingIsWeighted(loaded));
+  CheckLabeling(dig03, loaded);
+  GraphDistanceLabelingDestroy(&loaded);
+  GraphDistanceLabelingDestroy(&labeling);
+
+  // A file that is not an index
+  FILE* f = tmpfile();
+  assert(f != NULL);
+  fputs("not an index", f);
+  rewind(f);
+  assert(GraphDistanceLabelingLoad(f) == NULL);
+  fclose(f);
+
+  // Headers with sizes beyond the end of the file: nothing is allocated
+  // for them
+  f = tmpfile();
+  assert(f != NULL);
+  uint32_t header[4] = {0x314C4C50u, 4000000000u, 1, 1};
+  assert(fwrite(header, sizeof(uint32_t), 4, f) == 4);
+  rewind(f);
+  assert(GraphDistanceLabelingLoad(f) == NULL);
+  fclose(f);
+
+  f = tmpfile();
+  assert(f != NULL);
+  header[1] = 3;
+  size_t offsets[4] = {0, 3, 6, 9};
+  assert(fwrite(header, sizeof(uint32_t), 4, f) == 4);
+  assert(fwrite(offsets, sizeof(size_t), 4, f) == 4);
+  rewind(f);
+  assert(GraphDistanceLabelingLoad(f) == NULL);
+  fclose(f);
+
+  // Negative weights are not supported
+  Graph* dig04 = GraphCreate(3, 1, 1);
+  GraphAddWeightedEdge(dig04, 0, 1, 2.0);
+  GraphAddWeightedEdge(dig04, 1, 2, -1.0);
+  assert(GraphDistanceLabelingCreate(dig04) == NULL);
+
+  GraphDestroy(&g01);
+  GraphDestroy(&g02);
+  GraphDestroy(&dig03);
+  GraphDestroy(&dig04);
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Testing the landmark-based distance oracle
+//
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphBellmanFordAlg.h"
+#include "GraphDistanceOracle.h"
+
+// The bounds must hold the exact distance, and be exact at the landmarks
+static void CheckOracle(Graph* g, const GraphDistanceOracle* oracle) {
+  unsigned int numVertices = GraphGetNumVertices(g);
+  int* isLandmark = (int*)calloc(numVertices, sizeof(int));
+  assert(isLandmark != NULL);
+  for (unsigned int i = 0; i < GraphDistanceOracleGetNumLandmarks(oracle); i++) {
+    isLandmark[GraphDistanceOracleGetLandmark(oracle, i)] = 1;
+  }
+
+  for (unsigned int v = 0; v < numVertices; v++) {
+    GraphBellmanFordAlg* bf = GraphBellmanFordAlgExecute(g, v);
+    for (unsigned int w = 0; w < numVertices; w++) {
+      double distance = GraphBellmanFordAlgWeightedDistance(bf, w);
+      GraphDistanceOracleBounds bounds = GraphDistanceOracleQuery(oracle, v, w);
+      assert(bounds.lower <= distance && distance <= bounds.upper);
+      if (isLandmark[v] || isLandmark[w]) {
+        assert(bounds.lower == distance && bounds.upper == distance);
+      }
+    }
+    GraphBellmanFordAlgDestroy(&bf);
+  }
+  free(isLandmark);
+}
+
+int main(void) {
+  // A 6 x 6 grid, and a separate edge
+  Graph* g01 = GraphCreate(38, 0, 0);
+  for (unsigned int r = 0; r < 6; r++) {
+    for (unsigned int c = 0; c < 6; c++) {
+      if (c + 1 < 6) GraphAddEdge(g01, 6 * r + c, 6 * r + c + 1);
+      if (r + 1 < 6) GraphAddEdge(g01, 6 * r + c, 6 * (r + 1) + c);
+    }
+  }
+  GraphAddEdge(g01, 36, 37);
+
+  GraphDistanceOracleLandmarks strategies[] = {GRAPH_ORACLE_LANDMARKS_RANDOM,
+                                               GRAPH_ORACLE_LANDMARKS_DEGREE,
+                                               GRAPH_ORACLE_LANDMARKS_FARTHEST};
+  for (unsigned int s = 0; s < 3; s++) {
+    GraphDistanceOracle* oracle =
+        GraphDistanceOracleCreate(g01, 4, strategies[s], 2024);
+    assert(GraphDistanceOracleGetNumLandmarks(oracle) == 4);
+    CheckOracle(g01, oracle);
+    GraphDistanceOracleDestroy(&oracle);
+  }
+
+  // Farthest point: the second landmark is in the other component
+  GraphDistanceOracle* oracle =
+      GraphDistanceOracleCreate(g01, 2, GRAPH_ORACLE_LANDMARKS_FARTHEST, 7);
+  unsigned int first = GraphDistanceOracleGetLandmark(oracle, 0);
+  unsigned int second = GraphDistanceOracleGetLandmark(oracle, 1);
+  assert((first >= 36) != (second >= 36));
+  GraphDistanceOracleBounds bounds = GraphDistanceOracleQuery(oracle, 0, 37);
+  assert(bounds.lower == INFINITY && bounds.upper == INFINITY);
+  printf("Oracle memory: %zu bytes\n",
+         GraphDistanceOracleGetMemoryBytes(oracle));
+  GraphDistanceOracleDestroy(&oracle);
+
+  // A weighted digraph, with a negative weight
+  Graph* dig02 = GraphCreate(6, 1, 1);
+  GraphAddWeightedEdge(dig02, 0, 1, 4.0);
+  GraphAddWeightedEdge(dig02, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig02, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig02, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig02, 3, 2, 1.0);
+  GraphAddWeightedEdge(dig02, 3, 4, 0.5);
+  GraphAddWeightedEdge(dig02, 5, 0, 3.0);
+  for (unsigned int s = 0; s < 3; s++) {
+    oracle = GraphDistanceOracleCreate(dig02, 2, strategies[s], 11);
+    CheckOracle(dig02, oracle);
+    GraphDistanceOracleDestroy(&oracle);
+  }
+
+  // The negative cycle 0 -> 2 -> 1 -> 3 -> 0
+  Graph* dig03 = GraphCreate(4, 1, 1);
+  GraphAddWeightedEdge(dig03, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig03, 2, 1, -1.5);
+  GraphAddWeightedEdge(dig03, 1, 3, 2.0);
+  GraphAddWeightedEdge(dig03, 3, 0, -3.0);
+  assert(GraphDistanceOracleCreate(dig03, 1, GRAPH_ORACLE_LANDMARKS_RANDOM,
+                                   1) == NULL);
+
+  // The negative cycle 3 -> 4 -> 5 -> 3, out of reach of the landmark 0,
+  // which has the highest degree
+  Graph* dig04 = GraphCreate(6, 1, 1);
+  GraphAddWeightedEdge(dig04, 0, 1, 1.0);
+  GraphAddWeightedEdge(dig04, 0, 2, 2.0);
+  GraphAddWeightedEdge(dig04, 1, 0, 1.0);
+  GraphAddWeightedEdge(dig04, 3, 4, 1.0);
+  GraphAddWeightedEdge(dig04, 4, 5, -3.0);
+  GraphAddWeightedEdge(dig04, 5, 3, 1.0);
+  assert(GraphDistanceOracleCreate(dig04, 1, GRAPH_ORACLE_LANDMARKS_DEGREE,
+                                   1) == NULL);
+
+  GraphDestroy(&g01);
+  GraphDestroy(&dig02);
+  GraphDestroy(&dig03);
+  GraphDestroy(&dig04);
+
+  return 0;
+}
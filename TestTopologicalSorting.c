@@ -0,0 +1,80 @@
+//
+// Algoritmos e Estruturas de Dados --- 2024/2025
+//
+// Testing the Topological Sorting algorithm
+//
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "Graph.h"
+#include "GraphTopologicalSorting.h"
+
+// Every edge must go from an earlier to a later vertex in the sequence
+static void CheckSequence(Graph* g, const unsigned int* sequence) {
+  unsigned int numVertices = GraphGetNumVertices(g);
+  unsigned int* position =
+      (unsigned int*)malloc((numVertices + 1) * sizeof(unsigned int));
+  assert(position != NULL);
+  for (unsigned int i = 0; i < numVertices; i++) {
+    position[sequence[i]] = i;
+  }
+  for (unsigned int v = 0; v < numVertices; v++) {
+    unsigned int* adjacents = GraphGetAdjacentsTo(g, v);
+    for (unsigned int i = 1; i <= adjacents[0]; i++) {
+      assert(position[v] < position[adjacents[i]]);
+    }
+    free(adjacents);
+  }
+  free(position);
+}
+
+int main(void) {
+  // A dependency graph
+  Graph* dig01 = GraphCreate(6, 1, 0);
+  GraphAddEdge(dig01, 5, 2);
+  GraphAddEdge(dig01, 5, 0);
+  GraphAddEdge(dig01, 4, 0);
+  GraphAddEdge(dig01, 4, 1);
+  GraphAddEdge(dig01, 2, 3);
+  GraphAddEdge(dig01, 3, 1);
+  GraphCheckInvariants(dig01);
+
+  GraphTopoSort* result = GraphTopoSortCompute(dig01);
+  GraphTopoSortDisplaySequence(result);
+  assert(GraphTopoSortIsValid(result) == 1);
+
+  unsigned int* sequence = GraphTopoSortGetSequence(result);
+  assert(sequence != NULL);
+  CheckSequence(dig01, sequence);
+  free(sequence);
+  GraphTopoSortDestroy(&result);
+
+  // Adding an edge that closes a cycle: 2 -> 3 -> 1 -> 2
+  GraphAddEdge(dig01, 1, 2);
+  result = GraphTopoSortCompute(dig01);
+  GraphTopoSortDisplaySequence(result);
+  assert(GraphTopoSortIsValid(result) == 0);
+  assert(GraphTopoSortGetSequence(result) == NULL);
+  GraphTopoSortDestroy(&result);
+
+  // Reading a directed graph from file
+  FILE* file = fopen("DG_2.txt", "r");
+  Graph* dig03 = GraphFromFile(file);
+  fclose(file);
+  GraphCheckInvariants(dig03);
+
+  result = GraphTopoSortCompute(dig03);
+  GraphTopoSortDisplaySequence(result);
+  sequence = GraphTopoSortGetSequence(result);
+  if (sequence != NULL) {
+    CheckSequence(dig03, sequence);
+    free(sequence);
+  }
+  GraphTopoSortDestroy(&result);
+
+  GraphDestroy(&dig01);
+  GraphDestroy(&dig03);
+
+  return 0;
+}
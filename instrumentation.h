@@ -25,6 +25,11 @@
 /// Cpu time in seconds
 double cpu_time(void) ; ///
 
+/// Monotonic wall-clock time in seconds, with high resolution.
+/// Unaffected by clock adjustments; meaningful only as a difference.
+/// Safe to call from several threads.
+double monotonic_time(void) ; ///
+
 /// Ten counters should be more than enough
 #define NUMCOUNTERS 10
 